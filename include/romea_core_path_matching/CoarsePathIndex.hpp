@@ -0,0 +1,107 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__COARSEPATHINDEX_HPP_
+#define ROMEA_CORE_PATH_MATCHING__COARSEPATHINDEX_HPP_
+
+// std
+#include <utility>
+#include <vector>
+
+// eigen
+#include <Eigen/Core>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+struct BoundingBox2D
+{
+  BoundingBox2D();
+
+  void extend(const double & x, const double & y);
+  double squaredDistance(const Eigen::Vector2d & position) const;
+
+  Eigen::Vector2d min;
+  Eigen::Vector2d max;
+};
+
+// Two levels bounding boxes hierarchy (sections, then chunks of way points)
+// used to discard path parts located out of research radius
+class CoarsePathIndex
+{
+public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64;
+
+  CoarsePathIndex();
+
+  explicit CoarsePathIndex(const Path2D & path, const size_t & chunkSize = DEFAULT_CHUNK_SIZE);
+
+  std::vector<size_t> findCandidateSections(
+    const Eigen::Vector2d & position,
+    const double & researchRadius) const;
+
+  bool isCandidateSection(
+    const size_t & sectionIndex,
+    const Eigen::Vector2d & position,
+    const double & researchRadius) const;
+
+  // first and last way point indexes of chunks located in research radius
+  void findCandidateChunks(
+    const size_t & sectionIndex,
+    const Eigen::Vector2d & position,
+    const double & researchRadius,
+    std::vector<std::pair<size_t, size_t>> & chunks) const;
+
+  void updateSection(const size_t & sectionIndex, const PathSection2D & section);
+
+  // curvilinear abscissa of the first way point of a chunk from the start of its section
+  double getChunkCurvilinearAbscissa(
+    const size_t & sectionIndex,
+    const size_t & chunkIndex) const;
+
+  size_t getChunkSize() const;
+  size_t size() const;
+
+private:
+  void indexSection_(const PathSection2D & section, const size_t & sectionIndex);
+
+protected:
+  size_t chunkSize_;
+  std::vector<size_t> sectionSizes_;
+  std::vector<BoundingBox2D> sectionBoxes_;
+  std::vector<std::vector<BoundingBox2D>> chunkBoxes_;
+  std::vector<std::vector<double>> chunkCurvilinearAbscissas_;
+};
+
+// Coarse to fine global research, returns the same matched points than an
+// exhaustive research on all sections. In each section, the nearest way point is
+// looked for in candidate chunks only then the exact match is restricted to a
+// window of research radius around it, so cost does not grow with section length.
+std::vector<PathMatchedPoint2D> matchCoarseToFine(
+  const Path2D & path,
+  const CoarsePathIndex & pathIndex,
+  const Pose2D & vehiclePose,
+  const double & vehicleSpeed,
+  const double & predictionTimeHorizon,
+  const double & maximalResearchRadius);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__COARSEPATHINDEX_HPP_
@@ -0,0 +1,65 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__DEFERREDONTHEFLYPATHMATCHINGDIAGNOSTIC_HPP_
+#define ROMEA_CORE_PATH_MATCHING__DEFERREDONTHEFLYPATHMATCHINGDIAGNOSTIC_HPP_
+
+// std
+#include <atomic>
+#include <cstdint>
+
+// romea
+#include "romea_core_path_matching/OnTheFlyPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/RingBuffer.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Same reports as OnTheFlyPathMatchingDiagnostic but leader and follower stamps
+// are only recorded into lock free buffers, one per producer thread. Rates are
+// evaluated when makeReport is called, possibly from another thread.
+class DeferredOnTheFlyPathMatchingDiagnostic
+{
+public:
+  DeferredOnTheFlyPathMatchingDiagnostic();
+
+  void updateLeaderLocalisationRate(const Duration & duration);
+  void updateFollowerLocalisationRate(const Duration & duration);
+  void updatePathMatchingStatus(const bool & status);
+
+  DiagnosticReport makeReport(const core::Duration & duration);
+
+  size_t getDroppedStampsCount() const;
+
+private:
+  void flush_();
+
+protected:
+  enum class MatchingStatus : uint8_t {NONE, SUCCEEDED, FAILED};
+
+  static constexpr size_t STAMP_BUFFER_CAPACITY = 1024;
+
+  SpscRingBuffer<int64_t, STAMP_BUFFER_CAPACITY> leaderLocalisationStamps_;
+  SpscRingBuffer<int64_t, STAMP_BUFFER_CAPACITY> followerLocalisationStamps_;
+  std::atomic<MatchingStatus> pathMatchingStatus_;
+  std::atomic<size_t> droppedStampsCount_;
+  OnTheFlyPathMatchingDiagnostic diagnostic_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__DEFERREDONTHEFLYPATHMATCHINGDIAGNOSTIC_HPP_
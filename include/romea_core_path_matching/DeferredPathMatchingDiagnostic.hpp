@@ -0,0 +1,71 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__DEFERREDPATHMATCHINGDIAGNOSTIC_HPP_
+#define ROMEA_CORE_PATH_MATCHING__DEFERREDPATHMATCHINGDIAGNOSTIC_HPP_
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// romea
+#include "romea_core_path_matching/PathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/RingBuffer.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Same reports as PathMatchingDiagnostic but updates only record localisation
+// stamps and matching status into a lock free buffer. Rate checkups and report
+// strings are evaluated when makeReport is called, possibly from another thread.
+class DeferredPathMatchingDiagnostic
+{
+public:
+  explicit DeferredPathMatchingDiagnostic(const std::string & pathFilename);
+
+  DeferredPathMatchingDiagnostic(DeferredPathMatchingDiagnostic && other);
+
+  void updateLocalisationRate(const Duration & duration);
+  void updatePathMatchingStatus(const bool & status);
+  void setPathFilename(const std::string & pathFilename);
+
+  DiagnosticReport makeReport(const core::Duration & duration);
+
+  size_t getDroppedStampsCount() const;
+
+private:
+  static PathMatchingDiagnostic && release_(DeferredPathMatchingDiagnostic & diagnostic);
+
+  void flush_();
+
+protected:
+  enum class MatchingStatus : uint8_t {NONE, SUCCEEDED, FAILED};
+
+  static constexpr size_t STAMP_BUFFER_CAPACITY = 1024;
+
+  SpscRingBuffer<int64_t, STAMP_BUFFER_CAPACITY> localisationStamps_;
+  std::atomic<MatchingStatus> pathMatchingStatus_;
+  std::atomic<size_t> droppedStampsCount_;
+  std::shared_ptr<const std::string> pathFilename_;
+  PathMatchingDiagnostic diagnostic_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__DEFERREDPATHMATCHINGDIAGNOSTIC_HPP_
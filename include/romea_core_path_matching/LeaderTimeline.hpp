@@ -0,0 +1,80 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__LEADERTIMELINE_HPP_
+#define ROMEA_CORE_PATH_MATCHING__LEADERTIMELINE_HPP_
+
+// std
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// eigen
+#include <Eigen/Core>
+
+// romea
+#include "romea_core_common/time/Time.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+struct LeaderSample
+{
+  Eigen::Vector2d position;
+  Duration stamp;
+  double speed;
+};
+
+// Stamps and speeds of the leader when it drove through each way point of the
+// on the fly path, stored as columns parallel to the path way points.
+// Values between two way points are linearly interpolated.
+class LeaderTimeline
+{
+public:
+  LeaderTimeline();
+
+  void append(const double & curvilinearAbscissa, const Duration & stamp, const double & speed);
+
+  // move the oldest part of the timeline in and out of a trail archive
+  void eraseFront(const size_t & count);
+  void prepend(const LeaderTimeline & olderTimeline);
+
+  std::optional<double> getCurvilinearAbscissa(const Duration & stamp) const;
+  std::optional<Duration> getStamp(const double & curvilinearAbscissa) const;
+  std::optional<double> getSpeed(const double & curvilinearAbscissa) const;
+
+  const std::vector<double> & getCurvilinearAbscissas() const;
+  const std::vector<int64_t> & getStamps() const;
+  const std::vector<float> & getSpeeds() const;
+
+  size_t size() const;
+  bool empty() const;
+  void clear();
+
+private:
+  // index i and weight t such that abscissa = (1-t)*abscissas[i] + t*abscissas[i+1]
+  bool locate_(const double & curvilinearAbscissa, size_t & index, double & weight) const;
+
+protected:
+  std::vector<double> curvilinearAbscissas_;
+  std::vector<int64_t> stamps_;
+  std::vector<float> speeds_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__LEADERTIMELINE_HPP_
@@ -0,0 +1,120 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_PATH_MATCHING__LEADERTRAILARCHIVE_HPP_
+#define ROMEA_CORE_PATH_MATCHING__LEADERTRAILARCHIVE_HPP_
+
+// std
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// eigen
+#include <Eigen/Core>
+
+// romea
+#include "romea_core_path_matching/LeaderTimeline.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Compressed storage of the old parts of an on the fly path. Leader samples are
+// archived by chunks, each chunk keeps its first sample exactly and the following
+// ones as deltas of quantized values, about 12 bytes per sample. Quantization is
+// cumulative so the error does not drift along a chunk: position errors are below half
+// a millimeter, abscissas and stamps are rounded down to the millimeter and microsecond.
+// Memory usage is kept under a maximal value: when it is exceeded, the oldest chunks
+// are decimated first by halving their number of samples, keeping their first and
+// last ones, up to MAXIMAL_DECIMATION_LEVEL times, and are then dropped. The newest
+// chunk is only decimated when it is the last one left.
+class LeaderTrailArchive
+{
+public:
+  static constexpr double POSITION_QUANTIZATION_STEP = 0.001;
+  static constexpr double CURVILINEAR_ABSCISSA_QUANTIZATION_STEP = 0.001;
+  static constexpr double SPEED_QUANTIZATION_STEP = 0.001;
+  static constexpr int64_t STAMP_QUANTIZATION_STEP = 1000;
+  static constexpr uint8_t MAXIMAL_DECIMATION_LEVEL = 4;
+
+  explicit LeaderTrailArchive(
+    const size_t & maximalMemoryUsage = std::numeric_limits<size_t>::max());
+
+  // archive is decimated at once when it exceeds the new value
+  void setMaximalMemoryUsage(const size_t & maximalMemoryUsage);
+  size_t getMaximalMemoryUsage() const;
+
+  // samples must follow the last archived one, abscissas are the ones of the timeline
+  void archive(
+    const std::vector<LeaderSample> & leaderSamples,
+    const std::vector<double> & curvilinearAbscissas);
+
+  // remove the chunks from the newest one reached by the research radius to the end of
+  // the archive and return their samples in order, nothing is restored when none is reached
+  bool restore(
+    const Eigen::Vector2d & position,
+    const double & researchRadius,
+    std::vector<LeaderSample> & leaderSamples,
+    std::vector<double> & curvilinearAbscissas);
+
+  void decode(
+    std::vector<LeaderSample> & leaderSamples,
+    std::vector<double> & curvilinearAbscissas) const;
+
+  size_t size() const;
+  bool empty() const;
+  void clear();
+
+  size_t getMemoryUsage() const;
+
+protected:
+  struct Delta
+  {
+    int16_t x;
+    int16_t y;
+    uint16_t curvilinearAbscissa;
+    uint16_t speed;
+    uint32_t stamp;
+  };
+
+  struct Chunk
+  {
+    LeaderSample firstLeaderSample;
+    double firstCurvilinearAbscissa;
+    Eigen::Vector2d minimalPosition;
+    Eigen::Vector2d maximalPosition;
+    std::vector<Delta> deltas;
+    uint8_t decimationLevel;
+  };
+
+  static void decode_(
+    const Chunk & chunk,
+    std::vector<LeaderSample> & leaderSamples,
+    std::vector<double> & curvilinearAbscissas);
+
+  static void decimate_(Chunk & chunk);
+
+  void enforceMaximalMemoryUsage_();
+
+  std::vector<Chunk> chunks_;
+  size_t size_;
+  size_t maximalMemoryUsage_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__LEADERTRAILARCHIVE_HPP_
@@ -0,0 +1,81 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__LEADERTRAILJOURNAL_HPP_
+#define ROMEA_CORE_PATH_MATCHING__LEADERTRAILJOURNAL_HPP_
+
+// std
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/LeaderTimeline.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Matching state logged in the journal, matched point abscissa is given from the start
+// of the whole trail
+struct LeaderTrailState
+{
+  std::optional<PathMatchedPoint2D> matchedPoint;
+  size_t numberOfSkippedResearches;
+};
+
+// Append only binary log of the way points inserted in an on the fly path, of the
+// samples still pending in the path simplifier and of the matching state. Each record
+// starts with its kind which gives its size, a record or a header torn by a crash is
+// ignored on reading. Journals of previous versions are rewritten when opened.
+class LeaderTrailJournal
+{
+public:
+  explicit LeaderTrailJournal(const std::string & filename);
+
+  void append(const LeaderSample & leaderSample);
+
+  void appendPendingSample(const LeaderSample & leaderSample);
+
+  // the last state logged supersedes the previous ones
+  void appendState(const LeaderTrailState & state);
+
+  static std::vector<LeaderSample> read(const std::string & filename);
+
+  // pending samples are the ones logged after the last way point, state is the last
+  // one logged if any
+  static std::vector<LeaderSample> read(
+    const std::string & filename,
+    std::vector<LeaderSample> & pendingLeaderSamples,
+    std::optional<LeaderTrailState> & state);
+
+  // rewrite a compacted journal atomically, a journal opened on filename must be
+  // opened again to append to the new file
+  static void write(
+    const std::string & filename,
+    const std::vector<LeaderSample> & leaderSamples,
+    const std::vector<LeaderSample> & pendingLeaderSamples = {},
+    const std::optional<LeaderTrailState> & state = std::nullopt);
+
+protected:
+  std::ofstream file_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__LEADERTRAILJOURNAL_HPP_
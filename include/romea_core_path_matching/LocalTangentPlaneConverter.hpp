@@ -0,0 +1,82 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__LOCALTANGENTPLANECONVERTER_HPP_
+#define ROMEA_CORE_PATH_MATCHING__LOCALTANGENTPLANECONVERTER_HPP_
+
+// std
+#include <vector>
+
+// romea
+#include "romea_core_common/geodesy/ENUConverter.hpp"
+#include "romea_core_common/geodesy/GeodeticCoordinates.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Batched WGS84 to ENU conversion of horizontal coordinates. Over the extent of
+// a path, east and north are approximated by a second order expansion of the
+// exact conversion around the center of the extent. The approximation is checked
+// against the exact conversion on the extent borders and on a subset of the
+// points, every point is converted exactly when maximalError is exceeded.
+class LocalTangentPlaneConverter
+{
+public:
+  LocalTangentPlaneConverter(
+    const GeodeticCoordinates & wgs84Anchor,
+    const double & maximalError);
+
+  // latitudes and longitudes in radians, altitude of the anchor is used
+  void toENU(
+    const std::vector<double> & latitudes,
+    const std::vector<double> & longitudes,
+    std::vector<double> & east,
+    std::vector<double> & north);
+
+  // error measured on check points during the last conversion
+  double getEstimatedError() const;
+
+  bool usedExactConversion() const;
+
+private:
+  Eigen::Vector2d exactToENU_(const double & latitude, const double & longitude) const;
+
+  void expand_(const double & centerLatitude, const double & centerLongitude, const double & step);
+
+  Eigen::Vector2d approximateToENU_(const double & latitude, const double & longitude) const;
+
+protected:
+  ENUConverter enuConverter_;
+  double altitude_;
+  double maximalError_;
+
+  double centerLatitude_;
+  double centerLongitude_;
+  Eigen::Vector2d value_;
+  Eigen::Vector2d dLatitude_;
+  Eigen::Vector2d dLongitude_;
+  Eigen::Vector2d dLatitude2_;
+  Eigen::Vector2d dLongitude2_;
+  Eigen::Vector2d dLatitudeLongitude_;
+
+  double estimatedError_;
+  bool usedExactConversion_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__LOCALTANGENTPLANECONVERTER_HPP_
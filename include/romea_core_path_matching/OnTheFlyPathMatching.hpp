@@ -16,18 +16,30 @@
 #define ROMEA_CORE_PATH_MATCHING__ONTHEFLYPATHMATCHING_HPP_
 
 // std
+#include <memory>
 #include <optional>
 #include <string>
+#include <variant>
+#include <vector>
 
 // romea
 #include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/DeferredOnTheFlyPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/LeaderTimeline.hpp"
+#include "romea_core_path_matching/LeaderTrailArchive.hpp"
+#include "romea_core_path_matching/LeaderTrailJournal.hpp"
 #include "romea_core_path_matching/OnTheFlyPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/PathMatchingPolicies.hpp"
+#include "romea_core_path_matching/PoseChangeDetector.hpp"
+#include "romea_core_path_matching/StreamingPathSimplifier.hpp"
 
 namespace romea
 {
 namespace core
 {
 
+// With DiagnosticsMode::DEFERRED, updatePath and match only record stamps and status
+// and getReport may be called from another thread
 class OnTheFlyPathMatching
 {
 public:
@@ -36,13 +48,16 @@ public:
     const double & maximalResearchRadius,
     const double & interpolationWindowLength,
     const double & minimalDistanceBetweenTwoPoints,
-    const double & minimalVehicleSpeedToInsertPoint);
+    const double & minimalVehicleSpeedToInsertPoint,
+    const double & maximalLateralError = 0.0,
+    const DiagnosticsMode & diagnosticsMode = DiagnosticsMode::SYNCHRONOUS);
 
   bool updatePath(
     const Duration & stamp,
     const Pose2D & leaderVehiclePose,
     const Twist2D & leaderVehicleTwist);
 
+  // matched point curvilinear abscissa is given from the start of the whole trail
   std::optional<PathMatchedPoint2D> match(
     const Duration & stamp,
     const Pose2D & followerVehiclePose,
@@ -50,8 +65,41 @@ public:
 
   DiagnosticReport getReport(const Duration & stamp);
 
+  std::optional<Duration> getLeaderStamp(const PathMatchedPoint2D & matchedPoint) const;
+  std::optional<double> getLeaderSpeed(const PathMatchedPoint2D & matchedPoint) const;
+  std::optional<double> getLeaderCurvilinearAbscissa(const Duration & stamp) const;
+  // only the part of the trail which is not archived
+  const LeaderTimeline & getLeaderTimeline() const;
+  const LeaderTrailArchive & getTrailArchive() const;
+
   void reset();
 
+  // restore the path, the simplifier pending samples and the last matching state from
+  // journal when it exists then log each new way point in it, and the matching state
+  // each time the matched curve changes. Throws if the path has already been updated
+  void enableJournal(const std::string & filename);
+
+  // compacted journal of the whole trail and of the matching state, the enabled journal
+  // is opened again when the snapshot replaces it
+  void writeSnapshot(const std::string & filename);
+
+  // trail further than archivingDistance behind the matched point is moved into a
+  // compressed archive, it is restored when matching fails and the follower research
+  // radius reaches it again. Distance is at least the maximal research radius. Archive
+  // memory usage is bounded by decimating then dropping its oldest parts.
+  void enableTrailArchiving(
+    const double & archivingDistance,
+    const size_t & maximalArchiveMemoryUsage = DEFAULT_MAXIMAL_TRAIL_ARCHIVE_MEMORY_USAGE);
+
+  // While the follower pose and twist stay within thresholds of the last research that
+  // matched it on the trail, match calls extrapolate the matched point along the trail
+  // as long as it stays on its curve
+  void enableChangeDetection(const PoseChangeThresholds & thresholds);
+
+  size_t getNumberOfSkippedResearches() const;
+
+  static constexpr size_t DEFAULT_MAXIMAL_TRAIL_ARCHIVE_MEMORY_USAGE = 16 * 1024 * 1024;
+
 private:
   void tryMatchOnFullPath_(
     const Pose2D & followerVehiclePose,
@@ -63,18 +111,58 @@ private:
 
   double travelledDistance_(const Pose2D & leaderVehiclePose);
 
+  bool insertWayPoint_(const LeaderSample & leaderSample);
+
+  void addWayPoint_(const LeaderSample & leaderSample);
+
   double leaderVehicleSpeed_(const Twist2D & leaderVehicleTwist);
 
+  void archiveTrail_();
+
+  bool restoreArchivedTrail_(const Pose2D & followerVehiclePose);
+
+  void rebuildPathSection_(
+    const std::vector<LeaderSample> & restoredLeaderSamples,
+    const size_t & firstKeptWayPointIndex);
+
+  double archivedTrailLength_() const;
+
+  LeaderTrailState makeTrailState_() const;
+
+  void journalState_();
+
+  size_t nearestWayPointIndex_(const double & curvilinearAbscissa) const;
+
 protected:
+  using Diagnostics = std::variant<
+    OnTheFlyPathMatchingDiagnostic, DeferredOnTheFlyPathMatchingDiagnostic, NoDiagnostics>;
+
+  static Diagnostics makeDiagnostics_(const DiagnosticsMode & diagnosticsMode);
+
+  // trail is archived by chunks of at least this number of way points
+  static constexpr size_t MINIMAL_NUMBER_OF_ARCHIVED_WAY_POINTS = 256;
+
   double predictionTimeHorizon_;
   double maximalResearchRadius_;
   double interpolationWindowLength_;
   double minimalDistanceBetweenTwoPoints_;
   double minimalVehicleSpeedToInsertPoint_;
 
+  std::optional<Eigen::Vector2d> previousLeaderPosition_;
+  std::optional<StreamingPathSimplifier> pathSimplifier_;
+  std::vector<LeaderSample> pendingLeaderSamples_;
+
   PathSection2D pathSection_;
+  LeaderTimeline leaderTimeline_;
+  std::unique_ptr<LeaderTrailJournal> journal_;
+  std::string journalFilename_;
+  std::optional<size_t> journaledCurveIndex_;
+  std::optional<double> archivingDistance_;
+  LeaderTrailArchive trailArchive_;
   std::optional<PathMatchedPoint2D> matchedPoint_;
-  OnTheFlyPathMatchingDiagnostic diagnostics_;
+  PoseChangeDetector changeDetector_;
+  size_t numberOfSkippedResearches_;
+  Diagnostics diagnostics_;
 };
 
 }  // namespace core
@@ -0,0 +1,102 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHABSCISSAINDEX_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHABSCISSAINDEX_HPP_
+
+// std
+#include <optional>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Cumulative curvilinear abscissa of way points along all path sections, abscissa
+// of a section starts where the previous one ends as in PathPostureTable
+class PathAbscissaIndex
+{
+public:
+  PathAbscissaIndex();
+
+  explicit PathAbscissaIndex(const Path2D & path);
+
+  // reindex a section whose way points have changed, following sections are shifted
+  void updateSection(const size_t & sectionIndex, const PathSection2D & section);
+
+  // section and way point index of the segment containing curvilinearAbscissa,
+  // abscissas out of path are clamped
+  std::pair<size_t, size_t> locate(const double & curvilinearAbscissa) const;
+
+  size_t findSection(const double & curvilinearAbscissa) const;
+
+  // first and last sections overlapping [minimalAbscissa, maximalAbscissa]
+  std::pair<size_t, size_t> findSections(
+    const double & minimalCurvilinearAbscissa,
+    const double & maximalCurvilinearAbscissa) const;
+
+  std::optional<size_t> nextSection(const size_t & sectionIndex) const;
+  std::optional<size_t> previousSection(const size_t & sectionIndex) const;
+
+  double getSectionInitialCurvilinearAbscissa(const size_t & sectionIndex) const;
+  double getSectionFinalCurvilinearAbscissa(const size_t & sectionIndex) const;
+
+  double getCurvilinearAbscissa(const size_t & sectionIndex, const size_t & wayPointIndex) const;
+
+  // abscissas of all sections are stored contiguously, offset is the position of
+  // the first way point of a section
+  const std::vector<double> & getCurvilinearAbscissas() const;
+  size_t getSectionOffset(const size_t & sectionIndex) const;
+
+  size_t size() const;
+  bool empty() const;
+
+protected:
+  std::vector<double> curvilinearAbscissas_;
+  std::vector<size_t> sectionOffsets_;
+  std::vector<double> sectionInitialCurvilinearAbscissas_;
+};
+
+// Curvilinear abscissa of a matched point along all path sections, taken from its
+// curve way point and refined by the offset of the matched posture along the path
+double matchedPointCurvilinearAbscissa(
+  const Path2D & path,
+  const PathAbscissaIndex & abscissaIndex,
+  const PathMatchedPoint2D & matchedPoint);
+
+// Tracked research restricted to sections overlapping the tracking window around
+// the seed, its cost does not depend on the number of path sections. Speed is signed,
+// the window is stretched by the predicted displacement backward when reversing.
+// Neighbour sections are researched from their entry or their exit point.
+std::vector<PathMatchedPoint2D> matchInTrackingWindow(
+  const Path2D & path,
+  const CoarsePathIndex & pathIndex,
+  const PathAbscissaIndex & abscissaIndex,
+  const Pose2D & vehiclePose,
+  const double & vehicleSpeed,
+  const PathMatchedPoint2D & seed,
+  const double & trackingWindowLength,
+  const double & predictionTimeHorizon,
+  const double & maximalResearchRadius);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHABSCISSAINDEX_HPP_
@@ -0,0 +1,86 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHANNOTATIONINDEX_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHANNOTATIONINDEX_HPP_
+
+// std
+#include <vector>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/PathAbscissaIndex.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+struct IndexedPathAnnotation
+{
+  double curvilinearAbscissa;
+  PathAnnotation annotation;
+};
+
+// View on consecutive indexed annotations, valid as long as its index is unchanged
+class PathAnnotationRange
+{
+public:
+  using const_iterator = std::vector<IndexedPathAnnotation>::const_iterator;
+
+  PathAnnotationRange() = default;
+
+  PathAnnotationRange(const const_iterator & first, const const_iterator & last);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  size_t size() const;
+  bool empty() const;
+
+private:
+  const_iterator first_;
+  const_iterator last_;
+};
+
+// Path annotations sorted by the curvilinear abscissa of their way point, point index
+// of an annotation counts way points of all sections as PathAbscissaIndex does
+class PathAnnotationIndex
+{
+public:
+  PathAnnotationIndex();
+
+  PathAnnotationIndex(const Path2D & path, const PathAbscissaIndex & abscissaIndex);
+
+  // abscissas of annotations from firstPointIndex are taken again from an updated index
+  void update(const PathAbscissaIndex & abscissaIndex, const size_t & firstPointIndex);
+
+  // annotations between curvilinearAbscissa and curvilinearAbscissa + distance,
+  // distance is negative to look behind
+  PathAnnotationRange find(const double & curvilinearAbscissa, const double & distance) const;
+
+  const std::vector<IndexedPathAnnotation> & getAnnotations() const;
+
+  size_t size() const;
+  bool empty() const;
+
+private:
+  std::vector<IndexedPathAnnotation> annotations_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHANNOTATIONINDEX_HPP_
@@ -0,0 +1,93 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHCACHE_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHCACHE_HPP_
+
+// std
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/geodesy/GeodeticCoordinates.hpp"
+#include "romea_core_path/PathMatching2D.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+using PathWayPoints2D = std::vector<std::vector<PathWayPoint2D>>;
+
+// Way points expressed in the ENU frame of the anchor and annotations of a path file.
+// Curves are not cached, Path2D interpolates them again from way points on each load.
+struct CachedPath
+{
+  PathWayPoints2D wayPoints;
+  PathAnnotations annotations;
+};
+
+// Everything the cached path depends on
+struct PathCacheKey
+{
+  uint64_t fileHash;
+  GeodeticCoordinates wgs84Anchor;
+  double interpolationWindowLength;
+  double maximalConversionError;
+
+  uint64_t hash() const;
+};
+
+PathCacheKey makePathCacheKey(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & interpolationWindowLength,
+  const double & maximalConversionError);
+
+// Content hash (FNV-1a 64 bits) of a file
+uint64_t hashFile(const std::string & filename);
+
+// On disk cache of parsed and converted path files, entries are validated against
+// their key and silently rebuilt when stale. A hit only saves file parsing and WGS84
+// conversion: curves are interpolated again and path matching indexes and posture table
+// are rebuilt from them. The cache is disabled, loads missing and stores doing nothing,
+// when its directory cannot be created.
+class PathCache
+{
+public:
+  explicit PathCache(const std::string & directory);
+
+  bool isEnabled() const;
+
+  std::optional<CachedPath> load(const PathCacheKey & key) const;
+
+  void store(const PathCacheKey & key, const CachedPath & path) const;
+
+  std::string getEntryFilename(const PathCacheKey & key) const;
+
+protected:
+  std::string directory_;
+};
+
+void serialize(const PathCacheKey & key, const CachedPath & path, std::string & buffer);
+
+std::optional<CachedPath> deserialize(
+  const PathCacheKey & key, const char * data, const size_t & size);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHCACHE_HPP_
@@ -0,0 +1,57 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHLOADER_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHLOADER_HPP_
+
+// std
+#include <string>
+
+// romea
+#include "romea_core_common/geodesy/GeodeticCoordinates.hpp"
+#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/PathCache.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Maximal horizontal error of the approximated WGS84 to ENU conversion (in meters)
+constexpr double DEFAULT_WGS84_CONVERSION_MAXIMAL_ERROR = 0.001;
+
+// Load a path file and express its way points in the ENU frame of wgs84Anchor,
+// parsed way points and annotations are reused from pathCacheDirectory when not empty.
+// Curves, indexes and tables are built again from way points in any case, and the path
+// is loaded without cache when the directory cannot be created.
+Path2D loadPath(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & interpolationWindowLength,
+  const std::string & pathCacheDirectory = "",
+  const double & maximalConversionError = DEFAULT_WGS84_CONVERSION_MAXIMAL_ERROR);
+
+// True when the first line of the file is WGS84_WAYPOINTS, way points are then given as
+// "latitude longitude speed" lines (degrees) and sections are separated by empty lines
+bool isWGS84PathFile(const std::string & pathFilename);
+
+PathWayPoints2D loadWGS84WayPoints(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & maximalConversionError = DEFAULT_WGS84_CONVERSION_MAXIMAL_ERROR);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHLOADER_HPP_
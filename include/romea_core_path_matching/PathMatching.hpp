@@ -16,21 +16,38 @@
 #define ROMEA_CORE_PATH_MATCHING__PATHMATCHING_HPP_
 
 // std
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
 #include <optional>
 #include <string>
+#include <thread>
+#include <utility>
+#include <variant>
 #include <vector>
 
 // romea
 #include "romea_core_common/time/Time.hpp"
 #include "romea_core_common/geodesy/GeodeticCoordinates.hpp"
 #include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+#include "romea_core_path_matching/DeferredPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/PathAbscissaIndex.hpp"
+#include "romea_core_path_matching/PathAnnotationIndex.hpp"
 #include "romea_core_path_matching/PathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/PathMatchingPolicies.hpp"
+#include "romea_core_path_matching/PathPostureTable.hpp"
+#include "romea_core_path_matching/PathProjector.hpp"
+#include "romea_core_path_matching/PoseChangeDetector.hpp"
 
 namespace romea
 {
 namespace core
 {
 
+// With DiagnosticsMode::DEFERRED, match only records stamps and status and getReport
+// may be called from another thread. DiagnosticsMode::DISABLED returns empty reports.
 class PathMatching
 {
 public:
@@ -38,29 +55,164 @@ public:
     const std::string & pathFilename,
     const GeodeticCoordinates & wgs84Anchor,
     const double & maximalResearchRadius,
-    const double & interpolationWindowLength);
+    const double & interpolationWindowLength,
+    const std::string & pathCacheDirectory = "",
+    const DiagnosticsMode & diagnosticsMode = DiagnosticsMode::SYNCHRONOUS);
+
+  // waits for loading threads, their paths are dropped
+  ~PathMatching();
 
   const Path2D & getPath() const;
 
+  // Posture table of the path sampled every samplingStep meters, built for this path
+  // and the next ones only once enabled since its sampling costs one curve match per
+  // sample at each path change
+  void enablePostureTable(const double & samplingStep = DEFAULT_POSTURE_TABLE_SAMPLING_STEP);
+
+  // throws if the posture table is not enabled
+  const PathPostureTable & getPostureTable() const;
+
+  // keep the enabled posture tables of this path and of the next ones quantized. It only
+  // bounds the cost of the optional lookahead table on long paths, the path geometry and
+  // indexes read by matching stay at full precision so the memory they take is unchanged.
+  // Tables of paths with gaps stay at full precision
+  void enableCompactPostureTable();
+
+  // Frenet coordinates of points on the polylines of the current path, see PathProjector,
+  // tracking and diagnostics are untouched. Projections may run concurrently with each
+  // other but not with match, setPath or splicePath which may change the path.
+  void project(
+    const std::vector<Eigen::Vector2d> & points,
+    PathFrenetCoordinates2D & coordinates) const;
+
+  void project(
+    const std::vector<Eigen::Vector2d> & points,
+    PathFrenetCoordinates2D & coordinates,
+    const PathProjector::Executor & executor,
+    const size_t & numberOfTasks) const;
+
   void setPath(Path2D && path);
 
+  // Load and preprocess a path on a background thread, the prepared path is published
+  // once ready and swapped in by the next match call. Only the latest request is
+  // published: a load superseded by another load, setPath or splicePath is dropped and
+  // its future reports it as an error, as well as loading errors.
+  std::shared_future<void> loadPathAsync(
+    const std::string & pathFilename,
+    const GeodeticCoordinates & wgs84Anchor,
+    const std::string & pathCacheDirectory = "");
+
+  // Replace way points [firstWayPointIndex, lastWayPointIndex) of a section by wayPoints.
+  // Only the spliced section is reindexed and resampled from the splice onward, indexes
+  // and postures of the following sections are shifted. Tracked matched points are
+  // remapped onto the new geometry instead of being reset. Annotations are kept as is.
+  void splicePath(
+    const size_t & sectionIndex,
+    const size_t & firstWayPointIndex,
+    const size_t & lastWayPointIndex,
+    const std::vector<PathWayPoint2D> & wayPoints);
+
   std::vector<PathMatchedPoint2D> match(
     const Duration & stamp,
     const Pose2D & vehiclePose,
     const Twist2D & vehicleTwist,
     const double & predictionTimeHorizon = 0.0);
 
+  // Annotations between a matched point and distance ahead of it along the path,
+  // behind it for negative distances
+  PathAnnotationRange nextAnnotations(
+    const PathMatchedPoint2D & matchedPoint,
+    const double & distance) const;
+
+  // Each match call looks for annotations within this distance in the direction of
+  // motion along the path, given by the sign of the vehicle speed times the sign of the
+  // desired speed of the matched section, lookahead is disabled by default
+  void setAnnotationLookaheadDistance(const double & distance);
+
+  // Annotations ahead of each point returned by the last match call, ranges are
+  // valid until the path is changed
+  const std::vector<PathAnnotationRange> & getMatchedPointsAnnotations() const;
+
+  // While pose and twist stay within thresholds of the last research and the prediction
+  // time horizon is the same, match calls extrapolate previous matched points along the
+  // path instead of researching them, as long as they stay on their curve
+  void enableChangeDetection(const PoseChangeThresholds & thresholds);
+
+  size_t getNumberOfSkippedResearches() const;
+
+  // researches over the whole path since construction, tracking keeps it at one
+  // as long as the vehicle stays on the path, whatever its direction of motion
+  size_t getNumberOfGlobalResearches() const;
+
   DiagnosticReport getReport(const Duration & stamp);
 
   void reset();
 
+  static constexpr double DEFAULT_POSTURE_TABLE_SAMPLING_STEP = 0.1;
+
 protected:
+  struct PreparedPath
+  {
+    PreparedPath(
+      Path2D && path,
+      const double & interpolationWindowLength,
+      const std::optional<double> & postureTableSamplingStep,
+      const bool & compactPostureTable);
+
+    Path2D path;
+    CoarsePathIndex pathIndex;
+    PathAbscissaIndex abscissaIndex;
+    PathAnnotationIndex annotationIndex;
+    PathPostureTable postureTable;
+
+    // set by loading threads
+    uint64_t generation = 0;
+    std::string pathFilename;
+  };
+
+  // shared with loading threads so they never refer to this object, generation is
+  // increased by each change of path so that a superseded load is never swapped in
+  struct PreparedPathSlot
+  {
+    std::atomic<uint64_t> generation{0};
+    std::shared_ptr<PreparedPath> preparedPath;
+  };
+
+  using Diagnostics =
+    std::variant<PathMatchingDiagnostic, DeferredPathMatchingDiagnostic, NoDiagnostics>;
+
+  static Diagnostics makeDiagnostics_(
+    const std::string & pathFilename,
+    const DiagnosticsMode & diagnosticsMode);
+
+  void setPath_(PreparedPath && preparedPath);
+
+  void preparePostureTable_(PathPostureTable & postureTable, const Path2D & path) const;
+
+  void supersedePreparedPath_();
+
+  void joinLoaderThreads_(const bool & finishedOnly);
+
   double maximalResearchRadius_;
+  double interpolationWindowLength_;
 
   Path2D path_;
+  CoarsePathIndex pathIndex_;
+  PathAbscissaIndex abscissaIndex_;
+  PathAnnotationIndex annotationIndex_;
+  PathPostureTable postureTable_;
   std::vector<PathMatchedPoint2D> matchedPoints_;
+  std::vector<PathAnnotationRange> matchedPointsAnnotations_;
+  double annotationLookaheadDistance_;
+  std::shared_ptr<PreparedPathSlot> preparedPathSlot_;
+  std::vector<std::pair<std::thread, std::shared_future<void>>> loaderThreads_;
+  size_t numberOfGlobalResearches_;
+  std::optional<double> postureTableSamplingStep_;
+  bool compactPostureTable_;
+  PoseChangeDetector changeDetector_;
+  size_t numberOfSkippedResearches_;
 
-  PathMatchingDiagnostic diagnostics_;
+  Diagnostics diagnostics_;
 };
 
 }  // namespace core
@@ -34,6 +34,7 @@ public:
 
   void updateLocalisationRate(const Duration & duration);
   void updatePathMatchingStatus(const bool & status);
+  void setPathFilename(const std::string & pathFilename);
 
   DiagnosticReport makeReport(const core::Duration & duration);
 
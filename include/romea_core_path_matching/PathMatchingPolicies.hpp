@@ -0,0 +1,89 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHMATCHINGPOLICIES_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHMATCHINGPOLICIES_HPP_
+
+// std
+#include <string>
+
+// romea
+#include "romea_core_common/time/Time.hpp"
+#include "romea_core_common/diagnostic/CheckupRate.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Tracking policies: research around the previous matched point
+// within a window of TrackingWindowLength meters
+template<int TrackingWindowLength>
+struct Tracking
+{
+  static_assert(TrackingWindowLength > 0, "tracking window length must be positive");
+  static constexpr bool enabled = true;
+  static constexpr double windowLength = TrackingWindowLength;
+};
+
+// or always research on the whole path
+struct NoTracking
+{
+  static constexpr bool enabled = false;
+  static constexpr double windowLength = 0.;
+};
+
+// Prediction policies: time horizon used to compute future curvature
+struct NoPrediction
+{
+  static constexpr double timeHorizon() {return 0.;}
+};
+
+class ConstantPrediction
+{
+public:
+  explicit ConstantPrediction(const double & timeHorizon)
+  : timeHorizon_(timeHorizon) {}
+
+  double timeHorizon() const {return timeHorizon_;}
+
+private:
+  double timeHorizon_;
+};
+
+// Diagnostics policies: PathMatchingDiagnostic can be used directly,
+// NoDiagnostics compiles every update away
+struct NoDiagnostics
+{
+  NoDiagnostics() = default;
+  explicit NoDiagnostics(const std::string & /*pathFilename*/) {}
+
+  void updateLocalisationRate(const Duration & /*duration*/) {}
+  void updateLeaderLocalisationRate(const Duration & /*duration*/) {}
+  void updateFollowerLocalisationRate(const Duration & /*duration*/) {}
+  void updatePathMatchingStatus(const bool & /*status*/) {}
+  void setPathFilename(const std::string & /*pathFilename*/) {}
+
+  DiagnosticReport makeReport(const Duration & /*duration*/) {return DiagnosticReport();}
+};
+
+// Run time counterpart of diagnostics policies used by PathMatching and
+// OnTheFlyPathMatching: reports updated on each call, updates only recorded
+// and evaluated when a report is requested, or no diagnostics at all
+enum class DiagnosticsMode {SYNCHRONOUS, DEFERRED, DISABLED};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHMATCHINGPOLICIES_HPP_
@@ -0,0 +1,222 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHMATCHINGT_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHMATCHINGT_HPP_
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_common/time/Time.hpp"
+#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path/PathSectionMatching2D.hpp"
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+#include "romea_core_path_matching/PathAbscissaIndex.hpp"
+#include "romea_core_path_matching/PathMatchingPolicies.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Nearest matched point is used as tracking seed so it follows the vehicle
+// from one section to the next one
+inline PathMatchedPoint2D selectTrackingSeed(
+  const std::vector<PathMatchedPoint2D> & matchedPoints)
+{
+  return *std::min_element(
+    matchedPoints.begin(), matchedPoints.end(), [](const auto & p1, const auto & p2) {
+      return std::abs(p1.frenetPose.lateralDeviation) < std::abs(p2.frenetPose.lateralDeviation);
+    });
+}
+
+//-----------------------------------------------------------------------------
+// Return true when a global research over the whole path has been performed
+template<typename TrackingPolicy>
+inline bool matchOnPath(
+  const Path2D & path,
+  const CoarsePathIndex & pathIndex,
+  const PathAbscissaIndex & abscissaIndex,
+  const Pose2D & vehiclePose,
+  const double & vehicleSpeed,
+  const double & predictionTimeHorizon,
+  const double & maximalResearchRadius,
+  std::vector<PathMatchedPoint2D> & matchedPoints)
+{
+  if constexpr (TrackingPolicy::enabled) {
+    if (!matchedPoints.empty()) {
+      const PathMatchedPoint2D seed = selectTrackingSeed(matchedPoints);
+      matchedPoints = matchInTrackingWindow(
+        path,
+        pathIndex,
+        abscissaIndex,
+        vehiclePose,
+        vehicleSpeed,
+        seed,
+        TrackingPolicy::windowLength,
+        predictionTimeHorizon,
+        maximalResearchRadius);
+
+      // speed sign lags behind the vehicle during manoeuvres, prediction can then
+      // lead away from the vehicle so seed is kept and tracking retried without it
+      if (matchedPoints.empty() && vehicleSpeed * predictionTimeHorizon != 0) {
+        matchedPoints = matchInTrackingWindow(
+          path,
+          pathIndex,
+          abscissaIndex,
+          vehiclePose,
+          0.,
+          seed,
+          TrackingPolicy::windowLength,
+          0.,
+          maximalResearchRadius);
+      }
+
+      if (!matchedPoints.empty()) {
+        return false;
+      }
+    }
+  }
+
+  matchedPoints = matchCoarseToFine(
+    path,
+    pathIndex,
+    vehiclePose,
+    vehicleSpeed,
+    predictionTimeHorizon,
+    maximalResearchRadius);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename TrackingPolicy>
+inline void matchOnPathSection(
+  const PathSection2D & pathSection,
+  const Pose2D & vehiclePose,
+  const double & vehicleSpeed,
+  const double & predictionTimeHorizon,
+  const double & maximalResearchRadius,
+  std::optional<PathMatchedPoint2D> & matchedPoint)
+{
+  if constexpr (TrackingPolicy::enabled) {
+    if (matchedPoint.has_value()) {
+      matchedPoint = romea::core::match(
+        pathSection,
+        vehiclePose,
+        vehicleSpeed,
+        *matchedPoint,
+        TrackingPolicy::windowLength,
+        predictionTimeHorizon,
+        maximalResearchRadius);
+      return;
+    }
+  }
+
+  matchedPoint = romea::core::match(
+    pathSection,
+    vehiclePose,
+    vehicleSpeed,
+    predictionTimeHorizon,
+    maximalResearchRadius);
+}
+
+// Compile time specialised path matching, settings and unused features are
+// resolved at compile time so the matching loop can be fully inlined
+template<
+  typename TrackingPolicy,
+  typename PredictionPolicy = NoPrediction,
+  typename DiagnosticsPolicy = NoDiagnostics>
+class PathMatchingT
+{
+public:
+  PathMatchingT(
+    Path2D && path,
+    const double & maximalResearchRadius,
+    const PredictionPolicy & prediction = PredictionPolicy(),
+    DiagnosticsPolicy && diagnostics = DiagnosticsPolicy())
+  : maximalResearchRadius_(maximalResearchRadius),
+    path_(std::move(path)),
+    pathIndex_(path_),
+    abscissaIndex_(path_),
+    matchedPoints_(),
+    prediction_(prediction),
+    diagnostics_(std::move(diagnostics))
+  {
+  }
+
+  const Path2D & getPath() const
+  {
+    return path_;
+  }
+
+  void setPath(Path2D && path)
+  {
+    path_ = std::move(path);
+    pathIndex_ = CoarsePathIndex(path_);
+    abscissaIndex_ = PathAbscissaIndex(path_);
+    reset();
+  }
+
+  const std::vector<PathMatchedPoint2D> & match(
+    const Duration & stamp,
+    const Pose2D & vehiclePose,
+    const Twist2D & vehicleTwist)
+  {
+    diagnostics_.updateLocalisationRate(stamp);
+
+    matchOnPath<TrackingPolicy>(
+      path_,
+      pathIndex_,
+      abscissaIndex_,
+      vehiclePose,
+      vehicleTwist.linearSpeeds.x(),
+      prediction_.timeHorizon(),
+      maximalResearchRadius_,
+      matchedPoints_);
+
+    diagnostics_.updatePathMatchingStatus(!matchedPoints_.empty());
+    return matchedPoints_;
+  }
+
+  DiagnosticReport getReport(const Duration & stamp)
+  {
+    return diagnostics_.makeReport(stamp);
+  }
+
+  void reset()
+  {
+    matchedPoints_.clear();
+  }
+
+protected:
+  double maximalResearchRadius_;
+
+  Path2D path_;
+  CoarsePathIndex pathIndex_;
+  PathAbscissaIndex abscissaIndex_;
+  std::vector<PathMatchedPoint2D> matchedPoints_;
+
+  PredictionPolicy prediction_;
+  DiagnosticsPolicy diagnostics_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHMATCHINGT_HPP_
@@ -0,0 +1,159 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHPOSTURETABLE_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHPOSTURETABLE_HPP_
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Structure of arrays of path postures
+struct PathPostures2D
+{
+  void resize(const size_t & size);
+  size_t size() const;
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> course;
+  std::vector<double> curvature;
+  std::vector<double> dotCurvature;
+};
+
+// Path postures quantized by blocks of consecutive samples. Positions are 16 bit offsets
+// from the block origin, course is 16 bit over a whole turn, curvature and its derivative
+// are 16 bit scaled by their maximal magnitude in the block. Errors are below half a
+// quantization step: 0.5 mm on positions, 4.8e-5 rad on course and max|value|/65534
+// on curvature and its derivative.
+struct CompactPathPostures2D
+{
+  static constexpr double POSITION_QUANTIZATION_STEP = 0.001;
+  static constexpr double COURSE_QUANTIZATION_STEP = 2 * M_PI / 65536;
+
+  // block length along the path must fit 16 bit position offsets, returns false when
+  // a path gap moves a sample too far from its block origin
+  bool encode(const PathPostures2D & postures, const double & samplingStep);
+  void decode(PathPostures2D & postures) const;
+  void decode(const size_t & index, PathPosture2D & posture) const;
+  size_t size() const;
+
+  struct Block
+  {
+    double x;
+    double y;
+    double curvatureStep;
+    double dotCurvatureStep;
+  };
+
+  size_t blockSize = 1;
+  std::vector<Block> blocks;
+  std::vector<int16_t> x;
+  std::vector<int16_t> y;
+  std::vector<uint16_t> course;
+  std::vector<int16_t> curvature;
+  std::vector<int16_t> dotCurvature;
+};
+
+// Postures of the curves interpolated by path sections, sampled at uniform curvilinear
+// abscissa along all sections. Each section is sampled on its own curves and postures
+// are linearly interpolated between two samples of the same section only.
+// Table curvilinear abscissa is the cumulative polyline length used by PathAbscissaIndex,
+// matchedPointCurvilinearAbscissa maps a matched point onto it.
+class PathPostureTable
+{
+public:
+  PathPostureTable();
+
+  PathPostureTable(
+    const Path2D & path,
+    const double & samplingStep,
+    const double & interpolationWindowLength);
+
+  // resample postures located after curvilinearAbscissa, path must be unchanged before it
+  void update(const Path2D & path, const double & curvilinearAbscissa);
+
+  // resample postures of section sectionIndex located after curvilinearAbscissa, postures
+  // of the following sections are only moved by lengthOffset along the path
+  void update(
+    const Path2D & path,
+    const size_t & sectionIndex,
+    const double & curvilinearAbscissa,
+    const double & lengthOffset);
+
+  // keep samples quantized to cut the memory of this table by about 4, they are decoded
+  // on lookup and full precision samples are released, see CompactPathPostures2D for
+  // error bounds. Returns false and keeps full precision samples when the path has a gap
+  bool compact();
+  bool isCompact() const;
+  size_t getMemoryUsage() const;
+
+  PathPosture2D lookup(const double & curvilinearAbscissa) const;
+
+  void lookup(
+    const std::vector<double> & curvilinearAbscissas,
+    PathPostures2D & postures) const;
+
+  void lookup(
+    const double & initialCurvilinearAbscissa,
+    const double & curvilinearAbscissaStep,
+    const size_t & numberOfPostures,
+    PathPostures2D & postures) const;
+
+  double getSamplingStep() const;
+  double getMinimalCurvilinearAbscissa() const;
+  double getMaximalCurvilinearAbscissa() const;
+  // empty when the table is compact
+  const PathPostures2D & getSamples() const;
+  bool empty() const;
+
+private:
+  void flagSectionFirstSamples_();
+
+  void checkIsNotEmpty_() const;
+
+  size_t size_() const;
+
+  size_t firstUpdatedSample_(const double & curvilinearAbscissa) const;
+
+  void lookup_(
+    const double & curvilinearAbscissa,
+    PathPostures2D & postures,
+    const size_t & n) const;
+
+protected:
+  double samplingStep_;
+  double interpolationWindowLength_;
+  double minimalCurvilinearAbscissa_;
+  std::vector<size_t> sectionFirstSamples_;
+  // one flag per sample so that lookups know in constant time if they cross sections
+  std::vector<bool> sectionFirstSampleFlags_;
+  PathPostures2D samples_;
+  CompactPathPostures2D compactSamples_;
+  bool isCompact_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHPOSTURETABLE_HPP_
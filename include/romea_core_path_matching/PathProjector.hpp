@@ -0,0 +1,134 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__PATHPROJECTOR_HPP_
+#define ROMEA_CORE_PATH_MATCHING__PATHPROJECTOR_HPP_
+
+// std
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// eigen
+#include <Eigen/Core>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+#include "romea_core_path_matching/PathAbscissaIndex.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Structure of arrays of Frenet coordinates, lateral deviation is positive on the left
+// of the path, coordinates are NaN when no path point lies in the research radius
+struct PathFrenetCoordinates2D
+{
+  static constexpr size_t INVALID_SECTION_INDEX = std::numeric_limits<size_t>::max();
+
+  void resize(const size_t & size);
+  size_t size() const;
+
+  std::vector<double> curvilinearAbscissa;
+  std::vector<double> lateralDeviation;
+  std::vector<size_t> sectionIndex;
+};
+
+// Projection of point sets onto the polylines joining the way points of path sections,
+// not onto the curves interpolated by path matching: coordinates differ from the ones of
+// a matched point by the gap between polyline and curve, which is small for dense way
+// points. Projector is a view on a path and on its indexes, they must outlive it and
+// stay unchanged while it is used. Const methods can then be called concurrently.
+class PathProjector
+{
+public:
+  // runs task(0) to task(numberOfTasks - 1), possibly in parallel, and returns once all
+  // of them are done, e.g. on a thread pool owned by the caller
+  using Executor = std::function<void (size_t, const std::function<void(size_t)> &)>;
+
+  static constexpr size_t MINIMAL_NUMBER_OF_POINTS_PER_TASK = 1024;
+
+  PathProjector(
+    const Path2D & path,
+    const CoarsePathIndex & pathIndex,
+    const PathAbscissaIndex & abscissaIndex);
+
+  // consecutive points are expected to be close to each other, the distance to the path
+  // near the previous projection bounds the coarse research of the nearest segment
+  void project(
+    const std::vector<Eigen::Vector2d> & points,
+    const double & maximalResearchRadius,
+    PathFrenetCoordinates2D & coordinates) const;
+
+  // points are split in at most numberOfTasks ranges projected by executor
+  void project(
+    const std::vector<Eigen::Vector2d> & points,
+    const double & maximalResearchRadius,
+    PathFrenetCoordinates2D & coordinates,
+    const Executor & executor,
+    const size_t & numberOfTasks) const;
+
+private:
+  struct Projection
+  {
+    double squaredDistance;
+    double curvilinearAbscissa;
+    double lateralDeviation;
+    size_t wayPointIndex;
+    size_t sectionIndex;
+  };
+
+  void project_(
+    const std::vector<Eigen::Vector2d> & points,
+    const double & maximalResearchRadius,
+    const size_t & first,
+    const size_t & last,
+    PathFrenetCoordinates2D & coordinates) const;
+
+  // segments around the way point of the previous projection
+  void projectLocally_(
+    const Eigen::Vector2d & point,
+    Projection & projection) const;
+
+  // chunks of all sections located in research radius, projection is only improved
+  void projectGlobally_(
+    const Eigen::Vector2d & point,
+    const double & researchRadius,
+    std::vector<std::pair<size_t, size_t>> & chunks,
+    Projection & projection) const;
+
+  // segments of a section between way points [firstWayPointIndex, lastWayPointIndex],
+  // true if improved
+  bool projectOnSegments_(
+    const Eigen::Vector2d & point,
+    const size_t & sectionIndex,
+    const size_t & firstWayPointIndex,
+    const size_t & lastWayPointIndex,
+    Projection & projection) const;
+
+protected:
+  static constexpr size_t LOCAL_RESEARCH_HALF_WINDOW = 16;
+
+  const Path2D & path_;
+  const CoarsePathIndex & pathIndex_;
+  const PathAbscissaIndex & abscissaIndex_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__PATHPROJECTOR_HPP_
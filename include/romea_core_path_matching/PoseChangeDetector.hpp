@@ -0,0 +1,84 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_PATH_MATCHING__POSECHANGEDETECTOR_HPP_
+#define ROMEA_CORE_PATH_MATCHING__POSECHANGEDETECTOR_HPP_
+
+// std
+#include <optional>
+
+// romea
+#include "romea_core_path/PathMatching2D.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Changes of vehicle pose and twist below which a research is not worth redoing
+struct PoseChangeThresholds
+{
+  double position;
+  double yaw;
+  double linearSpeed;
+  double angularSpeed;
+};
+
+// Compare poses to the one of the last full research rather than to the previous pose,
+// so a vehicle creeping slower than the thresholds per sample is still researched
+class PoseChangeDetector
+{
+public:
+  // disabled, every pose is a change
+  PoseChangeDetector();
+
+  explicit PoseChangeDetector(const PoseChangeThresholds & thresholds);
+
+  // a research with another prediction time horizon is always a change
+  bool hasChanged(
+    const Pose2D & vehiclePose,
+    const Twist2D & vehicleTwist,
+    const double & predictionTimeHorizon) const;
+
+  void setReference(
+    const Pose2D & vehiclePose,
+    const Twist2D & vehicleTwist,
+    const double & predictionTimeHorizon);
+
+  // next pose will be a change
+  void reset();
+
+  bool isEnabled() const;
+
+private:
+  std::optional<PoseChangeThresholds> thresholds_;
+  std::optional<Pose2D> referencePose_;
+  Twist2D referenceTwist_;
+  double referencePredictionTimeHorizon_;
+};
+
+// Matched point moved along the tangent of its path posture to face the vehicle pose,
+// valid as long as the displacement is small compared to the path curvature radius.
+// Empty when the moved point leaves the curve of the matched point, i.e. goes past a
+// neighbouring way point of section, a research is then needed
+std::optional<PathMatchedPoint2D> extrapolateMatchedPoint(
+  const PathSection2D & section,
+  const PathMatchedPoint2D & matchedPoint,
+  const Pose2D & vehiclePose);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__POSECHANGEDETECTOR_HPP_
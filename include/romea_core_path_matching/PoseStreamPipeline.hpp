@@ -0,0 +1,117 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_PATH_MATCHING__POSESTREAMPIPELINE_HPP_
+#define ROMEA_CORE_PATH_MATCHING__POSESTREAMPIPELINE_HPP_
+
+// std
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// romea
+#include "romea_core_common/time/Time.hpp"
+#include "romea_core_path/PathMatching2D.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+class OnTheFlyPathMatching;
+class PathMatching;
+
+struct PoseSample
+{
+  Duration stamp;
+  Pose2D pose;
+  Twist2D twist;
+};
+
+// Feed a matcher from asynchronous pose streams on a worker thread. Leader poses are
+// all kept and handed over in batches between two follower matches, follower poses are
+// coalesced so only the latest one is matched and a backlog of stale poses is never
+// processed after a hiccup. Handlers are only called from the worker thread.
+class PoseStreamPipeline
+{
+public:
+  using LeaderHandler = std::function<void (const std::vector<PoseSample> &)>;
+  using FollowerHandler = std::function<void (const PoseSample &)>;
+
+  static constexpr size_t DEFAULT_MAXIMAL_NUMBER_OF_PENDING_LEADER_POSES = 1000;
+
+  PoseStreamPipeline(
+    LeaderHandler leaderHandler,
+    FollowerHandler followerHandler,
+    const size_t & maximalNumberOfPendingLeaderPoses =
+    DEFAULT_MAXIMAL_NUMBER_OF_PENDING_LEADER_POSES);
+
+  PoseStreamPipeline(const PoseStreamPipeline &) = delete;
+  PoseStreamPipeline & operator=(const PoseStreamPipeline &) = delete;
+
+  // pending poses are processed before the worker is stopped
+  ~PoseStreamPipeline();
+
+  // block while the maximal number of pending leader poses is reached
+  void pushLeaderPose(const Duration & stamp, const Pose2D & pose, const Twist2D & twist);
+
+  // replace the pending follower pose if it has not been matched yet
+  void pushFollowerPose(const Duration & stamp, const Pose2D & pose, const Twist2D & twist);
+
+  // wait until every pushed pose is processed, rethrow the first handler error
+  void flush();
+
+  size_t getNumberOfDroppedFollowerPoses() const;
+
+private:
+  void run_();
+
+  LeaderHandler leaderHandler_;
+  FollowerHandler followerHandler_;
+  size_t maximalNumberOfPendingLeaderPoses_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable workAvailable_;
+  std::condition_variable workDone_;
+  std::vector<PoseSample> pendingLeaderPoses_;
+  std::optional<PoseSample> pendingFollowerPose_;
+  size_t numberOfDroppedFollowerPoses_;
+  bool busy_;
+  bool stopped_;
+  std::exception_ptr error_;
+
+  std::thread worker_;
+};
+
+// Leader poses update the on the fly path, follower poses are matched on it
+std::unique_ptr<PoseStreamPipeline> makePoseStreamPipeline(
+  OnTheFlyPathMatching & matching,
+  std::function<void(const Duration &, const std::optional<PathMatchedPoint2D> &)> callback);
+
+// Follower poses are matched on the path, there is no leader stream
+std::unique_ptr<PoseStreamPipeline> makePoseStreamPipeline(
+  PathMatching & matching,
+  const double & predictionTimeHorizon,
+  std::function<void(const Duration &, const std::vector<PathMatchedPoint2D> &)> callback);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__POSESTREAMPIPELINE_HPP_
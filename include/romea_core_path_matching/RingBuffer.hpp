@@ -0,0 +1,81 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__RINGBUFFER_HPP_
+#define ROMEA_CORE_PATH_MATCHING__RINGBUFFER_HPP_
+
+// std
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace romea
+{
+namespace core
+{
+
+// Lock free single producer / single consumer ring buffer,
+// push fails instead of overwriting when the buffer is full
+template<typename T, size_t Capacity>
+class SpscRingBuffer
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of 2");
+
+public:
+  SpscRingBuffer()
+  : buffer_(),
+    head_(0),
+    tail_(0)
+  {
+  }
+
+  bool push(const T & value)
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    buffer_[tail & (Capacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T & value)
+  {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = buffer_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const
+  {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() {return Capacity;}
+
+private:
+  std::array<T, Capacity> buffer_;
+  alignas(64) std::atomic<size_t> head_;
+  alignas(64) std::atomic<size_t> tail_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__RINGBUFFER_HPP_
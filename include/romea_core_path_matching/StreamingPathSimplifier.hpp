@@ -0,0 +1,68 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROMEA_CORE_PATH_MATCHING__STREAMINGPATHSIMPLIFIER_HPP_
+#define ROMEA_CORE_PATH_MATCHING__STREAMINGPATHSIMPLIFIER_HPP_
+
+// std
+#include <optional>
+#include <vector>
+
+// eigen
+#include <Eigen/Core>
+
+namespace romea
+{
+namespace core
+{
+
+// Online polyline simplification (opening window): a point is only kept when the
+// points dropped since the previous kept point would be farther than
+// maximalLateralError from the simplified polyline. Kept points are never spaced
+// by more than maximalDistanceBetweenTwoPoints.
+class StreamingPathSimplifier
+{
+public:
+  StreamingPathSimplifier(
+    const double & maximalLateralError,
+    const double & maximalDistanceBetweenTwoPoints);
+
+  // returns the point to keep, if any
+  std::optional<Eigen::Vector2d> update(const Eigen::Vector2d & position);
+
+  // points received since the last kept point, none of them is kept yet
+  const std::vector<Eigen::Vector2d> & getPendingPoints() const;
+
+  void reset();
+
+  // resume from a state saved by a previous run
+  void restore(
+    const Eigen::Vector2d & lastKeptPoint,
+    const std::vector<Eigen::Vector2d> & pendingPoints);
+
+private:
+  bool canSkipPendingPoints_(const Eigen::Vector2d & position) const;
+
+protected:
+  double maximalLateralError_;
+  double maximalDistanceBetweenTwoPoints_;
+
+  std::optional<Eigen::Vector2d> lastKeptPoint_;
+  std::vector<Eigen::Vector2d> pendingPoints_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_PATH_MATCHING__STREAMINGPATHSIMPLIFIER_HPP_
@@ -0,0 +1,94 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_PATH_MATCHING__TRACING_HPP_
+#define ROMEA_CORE_PATH_MATCHING__TRACING_HPP_
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace romea
+{
+namespace core
+{
+
+struct TraceEvent
+{
+  const char * name;
+  int64_t begin;
+  int64_t duration;
+};
+
+// Trace events are recorded into a lock free ring buffer owned by the recording thread,
+// events are dropped instead of blocking when it is full. Dumping drains every buffer
+// into a Chrome trace that can be opened with Perfetto or chrome://tracing. Buffers of
+// finished threads are recycled by new threads once drained.
+class Tracer
+{
+public:
+  static constexpr size_t THREAD_BUFFER_CAPACITY = 4096;
+
+  // name must outlive the dump, string literals are expected
+  static void record(const char * name, const int64_t & begin, const int64_t & end);
+
+  static int64_t now();
+
+  static void writeChromeTrace(std::ostream & os);
+  static void writeChromeTrace(const std::string & filename);
+
+  static size_t getDroppedEventsCount();
+
+  // buffers allocated since start, in use or recycled
+  static size_t getNumberOfThreadBuffers();
+};
+
+// Record the lifetime of the scope as a trace event
+class TraceScope
+{
+public:
+  explicit TraceScope(const char * name)
+  : name_(name),
+    begin_(Tracer::now())
+  {
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope & operator=(const TraceScope &) = delete;
+
+  ~TraceScope()
+  {
+    Tracer::record(name_, begin_, Tracer::now());
+  }
+
+private:
+  const char * name_;
+  int64_t begin_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+// Trace points are compiled out unless ROMEA_PATH_MATCHING_TRACING is defined
+#ifdef ROMEA_PATH_MATCHING_TRACING
+#define ROMEA_PATH_MATCHING_TRACE_SCOPE(name) \
+  const romea::core::TraceScope romeaPathMatchingTraceScope(name)
+#else
+#define ROMEA_PATH_MATCHING_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif  // ROMEA_CORE_PATH_MATCHING__TRACING_HPP_
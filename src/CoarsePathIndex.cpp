@@ -0,0 +1,284 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_path/PathSectionMatching2D.hpp"
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+
+namespace
+{
+double polylineLength(
+  const std::vector<double> & X,
+  const std::vector<double> & Y,
+  const size_t & firstIndex,
+  const size_t & lastIndex)
+{
+  double length = 0;
+  for (size_t n = firstIndex + 1; n <= lastIndex; ++n) {
+    length += std::hypot(X[n] - X[n - 1], Y[n] - Y[n - 1]);
+  }
+  return length;
+}
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+BoundingBox2D::BoundingBox2D()
+: min(Eigen::Vector2d::Constant(std::numeric_limits<double>::max())),
+  max(Eigen::Vector2d::Constant(std::numeric_limits<double>::lowest()))
+{
+}
+
+//-----------------------------------------------------------------------------
+void BoundingBox2D::extend(const double & x, const double & y)
+{
+  min.x() = std::min(min.x(), x);
+  min.y() = std::min(min.y(), y);
+  max.x() = std::max(max.x(), x);
+  max.y() = std::max(max.y(), y);
+}
+
+//-----------------------------------------------------------------------------
+double BoundingBox2D::squaredDistance(const Eigen::Vector2d & position) const
+{
+  double dx = std::max({min.x() - position.x(), 0., position.x() - max.x()});
+  double dy = std::max({min.y() - position.y(), 0., position.y() - max.y()});
+  return dx * dx + dy * dy;
+}
+
+//-----------------------------------------------------------------------------
+CoarsePathIndex::CoarsePathIndex()
+: chunkSize_(DEFAULT_CHUNK_SIZE),
+  sectionSizes_(),
+  sectionBoxes_(),
+  chunkBoxes_(),
+  chunkCurvilinearAbscissas_()
+{
+}
+
+//-----------------------------------------------------------------------------
+CoarsePathIndex::CoarsePathIndex(const Path2D & path, const size_t & chunkSize)
+: chunkSize_(std::max<size_t>(chunkSize, 2)),
+  sectionSizes_(path.size()),
+  sectionBoxes_(path.size()),
+  chunkBoxes_(path.size()),
+  chunkCurvilinearAbscissas_(path.size())
+{
+  for (size_t n = 0; n < path.size(); ++n) {
+    indexSection_(path.getSection(n), n);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CoarsePathIndex::updateSection(const size_t & sectionIndex, const PathSection2D & section)
+{
+  if (sectionIndex >= sectionBoxes_.size()) {
+    sectionSizes_.resize(sectionIndex + 1);
+    sectionBoxes_.resize(sectionIndex + 1);
+    chunkBoxes_.resize(sectionIndex + 1);
+    chunkCurvilinearAbscissas_.resize(sectionIndex + 1);
+  }
+  indexSection_(section, sectionIndex);
+}
+
+//-----------------------------------------------------------------------------
+void CoarsePathIndex::indexSection_(const PathSection2D & section, const size_t & sectionIndex)
+{
+  const auto & X = section.getX();
+  const auto & Y = section.getY();
+
+  BoundingBox2D & sectionBox = sectionBoxes_[sectionIndex];
+  std::vector<BoundingBox2D> & chunkBoxes = chunkBoxes_[sectionIndex];
+  std::vector<double> & chunkAbscissas = chunkCurvilinearAbscissas_[sectionIndex];
+  sectionBox = BoundingBox2D();
+  chunkBoxes.clear();
+  chunkAbscissas.clear();
+
+  sectionSizes_[sectionIndex] = X.size();
+  if (X.empty()) {
+    return;
+  }
+
+  // consecutive chunks share one way point so segments between chunks are covered
+  size_t first = 0;
+  double abscissa = 0;
+  do {
+    size_t last = std::min(first + chunkSize_ - 1, X.size() - 1);
+    BoundingBox2D chunkBox;
+    for (size_t n = first; n <= last; ++n) {
+      chunkBox.extend(X[n], Y[n]);
+    }
+    sectionBox.extend(chunkBox.min.x(), chunkBox.min.y());
+    sectionBox.extend(chunkBox.max.x(), chunkBox.max.y());
+    chunkBoxes.push_back(chunkBox);
+    chunkAbscissas.push_back(abscissa);
+    abscissa += polylineLength(X, Y, first, last);
+    first = last;
+  } while (first + 1 < X.size());
+}
+
+//-----------------------------------------------------------------------------
+std::vector<size_t> CoarsePathIndex::findCandidateSections(
+  const Eigen::Vector2d & position,
+  const double & researchRadius) const
+{
+  std::vector<size_t> sectionIndexes;
+  for (size_t n = 0; n < sectionBoxes_.size(); ++n) {
+    if (isCandidateSection(n, position, researchRadius)) {
+      sectionIndexes.push_back(n);
+    }
+  }
+  return sectionIndexes;
+}
+
+//-----------------------------------------------------------------------------
+bool CoarsePathIndex::isCandidateSection(
+  const size_t & sectionIndex,
+  const Eigen::Vector2d & position,
+  const double & researchRadius) const
+{
+  const double squaredResearchRadius = researchRadius * researchRadius;
+  if (sectionBoxes_[sectionIndex].squaredDistance(position) > squaredResearchRadius) {
+    return false;
+  }
+
+  const auto & chunkBoxes = chunkBoxes_[sectionIndex];
+  return std::any_of(
+    chunkBoxes.begin(), chunkBoxes.end(), [&](const BoundingBox2D & chunkBox) {
+      return chunkBox.squaredDistance(position) <= squaredResearchRadius;
+    });
+}
+
+//-----------------------------------------------------------------------------
+void CoarsePathIndex::findCandidateChunks(
+  const size_t & sectionIndex,
+  const Eigen::Vector2d & position,
+  const double & researchRadius,
+  std::vector<std::pair<size_t, size_t>> & chunks) const
+{
+  chunks.clear();
+
+  const double squaredResearchRadius = researchRadius * researchRadius;
+  if (sectionBoxes_[sectionIndex].squaredDistance(position) > squaredResearchRadius) {
+    return;
+  }
+
+  const auto & chunkBoxes = chunkBoxes_[sectionIndex];
+  for (size_t n = 0; n < chunkBoxes.size(); ++n) {
+    if (chunkBoxes[n].squaredDistance(position) <= squaredResearchRadius) {
+      size_t first = n * (chunkSize_ - 1);
+      size_t last = std::min(first + chunkSize_ - 1, sectionSizes_[sectionIndex] - 1);
+      chunks.emplace_back(first, last);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+double CoarsePathIndex::getChunkCurvilinearAbscissa(
+  const size_t & sectionIndex,
+  const size_t & chunkIndex) const
+{
+  return chunkCurvilinearAbscissas_[sectionIndex][chunkIndex];
+}
+
+//-----------------------------------------------------------------------------
+size_t CoarsePathIndex::getChunkSize() const
+{
+  return chunkSize_;
+}
+
+//-----------------------------------------------------------------------------
+size_t CoarsePathIndex::size() const
+{
+  return sectionBoxes_.size();
+}
+
+//-----------------------------------------------------------------------------
+std::vector<PathMatchedPoint2D> matchCoarseToFine(
+  const Path2D & path,
+  const CoarsePathIndex & pathIndex,
+  const Pose2D & vehiclePose,
+  const double & vehicleSpeed,
+  const double & predictionTimeHorizon,
+  const double & maximalResearchRadius)
+{
+  const size_t chunkStep = pathIndex.getChunkSize() - 1;
+
+  std::vector<PathMatchedPoint2D> matchedPoints;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  for (size_t n = 0; n < path.size(); ++n) {
+    pathIndex.findCandidateChunks(n, vehiclePose.position, maximalResearchRadius, chunks);
+    if (chunks.empty()) {
+      continue;
+    }
+
+    const PathSection2D & section = path.getSection(n);
+    const auto & X = section.getX();
+    const auto & Y = section.getY();
+
+    // way points out of candidate chunks are further than research radius
+    double nearestSquaredDistance = std::numeric_limits<double>::max();
+    size_t nearestIndex = 0;
+    size_t nearestChunkIndex = 0;
+    for (const auto & [first, last] : chunks) {
+      for (size_t i = first; i <= last; ++i) {
+        const double squaredDistance =
+          (Eigen::Vector2d(X[i], Y[i]) - vehiclePose.position).squaredNorm();
+        if (squaredDistance < nearestSquaredDistance) {
+          nearestSquaredDistance = squaredDistance;
+          nearestIndex = i;
+          nearestChunkIndex = first / chunkStep;
+        }
+      }
+    }
+
+    PathMatchedPoint2D seed;
+    seed.sectionIndex = n;
+    seed.curveIndex = nearestIndex;
+    seed.pathPosture.position = Eigen::Vector2d(X[nearestIndex], Y[nearestIndex]);
+    seed.frenetPose.curvilinearAbscissa =
+      pathIndex.getChunkCurvilinearAbscissa(n, nearestChunkIndex) +
+      polylineLength(X, Y, nearestChunkIndex * chunkStep, nearestIndex);
+
+    // nearest way point of the window is the nearest one of the whole section
+    auto matchedPoint = romea::core::match(
+      section,
+      vehiclePose,
+      vehicleSpeed,
+      seed,
+      maximalResearchRadius,
+      predictionTimeHorizon,
+      maximalResearchRadius);
+
+    if (matchedPoint.has_value()) {
+      matchedPoint->sectionIndex = n;
+      matchedPoints.push_back(*matchedPoint);
+    }
+  }
+  return matchedPoints;
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,96 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// romea
+#include "romea_core_path_matching/DeferredOnTheFlyPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+DeferredOnTheFlyPathMatchingDiagnostic::DeferredOnTheFlyPathMatchingDiagnostic()
+: leaderLocalisationStamps_(),
+  followerLocalisationStamps_(),
+  pathMatchingStatus_(MatchingStatus::NONE),
+  droppedStampsCount_(0),
+  diagnostic_()
+{
+}
+
+//-----------------------------------------------------------------------------
+void DeferredOnTheFlyPathMatchingDiagnostic::updateLeaderLocalisationRate(
+  const Duration & duration)
+{
+  if (!leaderLocalisationStamps_.push(duration.count())) {
+    droppedStampsCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void DeferredOnTheFlyPathMatchingDiagnostic::updateFollowerLocalisationRate(
+  const Duration & duration)
+{
+  if (!followerLocalisationStamps_.push(duration.count())) {
+    droppedStampsCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void DeferredOnTheFlyPathMatchingDiagnostic::updatePathMatchingStatus(const bool & status)
+{
+  pathMatchingStatus_.store(
+    status ? MatchingStatus::SUCCEEDED : MatchingStatus::FAILED,
+    std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+DiagnosticReport DeferredOnTheFlyPathMatchingDiagnostic::makeReport(
+  const core::Duration & duration)
+{
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("DeferredOnTheFlyPathMatchingDiagnostic::makeReport");
+  flush_();
+  return diagnostic_.makeReport(duration);
+}
+
+//-----------------------------------------------------------------------------
+size_t DeferredOnTheFlyPathMatchingDiagnostic::getDroppedStampsCount() const
+{
+  return droppedStampsCount_.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+void DeferredOnTheFlyPathMatchingDiagnostic::flush_()
+{
+  int64_t stamp;
+  while (leaderLocalisationStamps_.pop(stamp)) {
+    diagnostic_.updateLeaderLocalisationRate(Duration(stamp));
+  }
+
+  while (followerLocalisationStamps_.pop(stamp)) {
+    diagnostic_.updateFollowerLocalisationRate(Duration(stamp));
+  }
+
+  MatchingStatus status = pathMatchingStatus_.exchange(
+    MatchingStatus::NONE, std::memory_order_acq_rel);
+  if (status != MatchingStatus::NONE) {
+    diagnostic_.updatePathMatchingStatus(status == MatchingStatus::SUCCEEDED);
+  }
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,117 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <memory>
+#include <string>
+#include <utility>
+
+// romea
+#include "romea_core_path_matching/DeferredPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+DeferredPathMatchingDiagnostic::DeferredPathMatchingDiagnostic(const std::string & pathFilename)
+: localisationStamps_(),
+  pathMatchingStatus_(MatchingStatus::NONE),
+  droppedStampsCount_(0),
+  pathFilename_(),
+  diagnostic_(pathFilename)
+{
+}
+
+//-----------------------------------------------------------------------------
+DeferredPathMatchingDiagnostic::DeferredPathMatchingDiagnostic(
+  DeferredPathMatchingDiagnostic && other)
+: localisationStamps_(),
+  pathMatchingStatus_(MatchingStatus::NONE),
+  droppedStampsCount_(0),
+  pathFilename_(),
+  diagnostic_(release_(other))
+{
+}
+
+//-----------------------------------------------------------------------------
+void DeferredPathMatchingDiagnostic::updateLocalisationRate(const Duration & duration)
+{
+  if (!localisationStamps_.push(duration.count())) {
+    droppedStampsCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void DeferredPathMatchingDiagnostic::updatePathMatchingStatus(const bool & status)
+{
+  pathMatchingStatus_.store(
+    status ? MatchingStatus::SUCCEEDED : MatchingStatus::FAILED,
+    std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+void DeferredPathMatchingDiagnostic::setPathFilename(const std::string & pathFilename)
+{
+  // path changes are rare, the name is handed over to the reporting thread as a whole
+  std::atomic_store(&pathFilename_, std::make_shared<const std::string>(pathFilename));
+}
+
+//-----------------------------------------------------------------------------
+DiagnosticReport DeferredPathMatchingDiagnostic::makeReport(const core::Duration & duration)
+{
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("DeferredPathMatchingDiagnostic::makeReport");
+  flush_();
+  return diagnostic_.makeReport(duration);
+}
+
+//-----------------------------------------------------------------------------
+size_t DeferredPathMatchingDiagnostic::getDroppedStampsCount() const
+{
+  return droppedStampsCount_.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+PathMatchingDiagnostic && DeferredPathMatchingDiagnostic::release_(
+  DeferredPathMatchingDiagnostic & diagnostic)
+{
+  diagnostic.flush_();
+  return std::move(diagnostic.diagnostic_);
+}
+
+//-----------------------------------------------------------------------------
+void DeferredPathMatchingDiagnostic::flush_()
+{
+  int64_t stamp;
+  while (localisationStamps_.pop(stamp)) {
+    diagnostic_.updateLocalisationRate(Duration(stamp));
+  }
+
+  if (auto pathFilename = std::atomic_exchange(
+      &pathFilename_, std::shared_ptr<const std::string>()))
+  {
+    diagnostic_.setPathFilename(*pathFilename);
+  }
+
+  MatchingStatus status = pathMatchingStatus_.exchange(
+    MatchingStatus::NONE, std::memory_order_acq_rel);
+  if (status != MatchingStatus::NONE) {
+    diagnostic_.updatePathMatchingStatus(status == MatchingStatus::SUCCEEDED);
+  }
+}
+
+}  // namespace core
+}  // namespace romea
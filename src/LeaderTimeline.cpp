@@ -0,0 +1,177 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/LeaderTimeline.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+LeaderTimeline::LeaderTimeline()
+: curvilinearAbscissas_(),
+  stamps_(),
+  speeds_()
+{
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTimeline::append(
+  const double & curvilinearAbscissa,
+  const Duration & stamp,
+  const double & speed)
+{
+  curvilinearAbscissas_.push_back(curvilinearAbscissa);
+  // stamps are kept monotonic so they can be searched by dichotomy
+  stamps_.push_back(stamps_.empty() ? stamp.count() : std::max(stamps_.back(), stamp.count()));
+  speeds_.push_back(static_cast<float>(speed));
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTimeline::eraseFront(const size_t & count)
+{
+  const size_t erased = std::min(count, size());
+  curvilinearAbscissas_.erase(
+    curvilinearAbscissas_.begin(), curvilinearAbscissas_.begin() + erased);
+  stamps_.erase(stamps_.begin(), stamps_.begin() + erased);
+  speeds_.erase(speeds_.begin(), speeds_.begin() + erased);
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTimeline::prepend(const LeaderTimeline & olderTimeline)
+{
+  curvilinearAbscissas_.insert(
+    curvilinearAbscissas_.begin(),
+    olderTimeline.curvilinearAbscissas_.begin(),
+    olderTimeline.curvilinearAbscissas_.end());
+  stamps_.insert(stamps_.begin(), olderTimeline.stamps_.begin(), olderTimeline.stamps_.end());
+  speeds_.insert(speeds_.begin(), olderTimeline.speeds_.begin(), olderTimeline.speeds_.end());
+}
+
+//-----------------------------------------------------------------------------
+std::optional<double> LeaderTimeline::getCurvilinearAbscissa(const Duration & stamp) const
+{
+  if (stamps_.empty() || stamp.count() < stamps_.front() || stamp.count() > stamps_.back()) {
+    return std::nullopt;
+  }
+
+  auto it = std::upper_bound(stamps_.begin(), stamps_.end(), stamp.count());
+  size_t index = std::min<size_t>(std::distance(stamps_.begin(), it), stamps_.size() - 1);
+  if (index == 0 || stamps_[index] == stamps_[index - 1]) {
+    return curvilinearAbscissas_[index];
+  }
+
+  double weight = static_cast<double>(stamp.count() - stamps_[index - 1]) /
+    (stamps_[index] - stamps_[index - 1]);
+  return curvilinearAbscissas_[index - 1] +
+         weight * (curvilinearAbscissas_[index] - curvilinearAbscissas_[index - 1]);
+}
+
+//-----------------------------------------------------------------------------
+std::optional<Duration> LeaderTimeline::getStamp(const double & curvilinearAbscissa) const
+{
+  size_t index;
+  double weight;
+  if (!locate_(curvilinearAbscissa, index, weight)) {
+    return std::nullopt;
+  }
+
+  return Duration(
+    stamps_[index] + static_cast<int64_t>(
+      std::round(weight * (stamps_[index + 1] - stamps_[index]))));
+}
+
+//-----------------------------------------------------------------------------
+std::optional<double> LeaderTimeline::getSpeed(const double & curvilinearAbscissa) const
+{
+  size_t index;
+  double weight;
+  if (!locate_(curvilinearAbscissa, index, weight)) {
+    return std::nullopt;
+  }
+
+  return speeds_[index] + weight * (speeds_[index + 1] - speeds_[index]);
+}
+
+//-----------------------------------------------------------------------------
+bool LeaderTimeline::locate_(
+  const double & curvilinearAbscissa,
+  size_t & index,
+  double & weight) const
+{
+  if (curvilinearAbscissas_.size() < 2 ||
+    curvilinearAbscissa < curvilinearAbscissas_.front() ||
+    curvilinearAbscissa > curvilinearAbscissas_.back())
+  {
+    return false;
+  }
+
+  auto it = std::upper_bound(
+    curvilinearAbscissas_.begin(), curvilinearAbscissas_.end(), curvilinearAbscissa);
+  index = std::min<size_t>(
+    std::distance(curvilinearAbscissas_.begin(), it), curvilinearAbscissas_.size() - 1) - 1;
+
+  double length = curvilinearAbscissas_[index + 1] - curvilinearAbscissas_[index];
+  weight = length > 0 ? (curvilinearAbscissa - curvilinearAbscissas_[index]) / length : 0;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<double> & LeaderTimeline::getCurvilinearAbscissas() const
+{
+  return curvilinearAbscissas_;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<int64_t> & LeaderTimeline::getStamps() const
+{
+  return stamps_;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<float> & LeaderTimeline::getSpeeds() const
+{
+  return speeds_;
+}
+
+//-----------------------------------------------------------------------------
+size_t LeaderTimeline::size() const
+{
+  return stamps_.size();
+}
+
+//-----------------------------------------------------------------------------
+bool LeaderTimeline::empty() const
+{
+  return stamps_.empty();
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTimeline::clear()
+{
+  curvilinearAbscissas_.clear();
+  stamps_.clear();
+  speeds_.clear();
+}
+
+}  // namespace core
+}  // namespace romea
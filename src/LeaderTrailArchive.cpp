@@ -0,0 +1,320 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/LeaderTrailArchive.hpp"
+
+namespace
+{
+
+int64_t quantize(const double & value, const double & step)
+{
+  return std::llround(value / step);
+}
+
+template<typename T>
+bool fits(const int64_t & value)
+{
+  return value >= std::numeric_limits<T>::min() && value <= std::numeric_limits<T>::max();
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+LeaderTrailArchive::LeaderTrailArchive(const size_t & maximalMemoryUsage)
+: chunks_(),
+  size_(0),
+  maximalMemoryUsage_(maximalMemoryUsage)
+{
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::setMaximalMemoryUsage(const size_t & maximalMemoryUsage)
+{
+  maximalMemoryUsage_ = maximalMemoryUsage;
+  enforceMaximalMemoryUsage_();
+}
+
+//-----------------------------------------------------------------------------
+size_t LeaderTrailArchive::getMaximalMemoryUsage() const
+{
+  return maximalMemoryUsage_;
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::archive(
+  const std::vector<LeaderSample> & leaderSamples,
+  const std::vector<double> & curvilinearAbscissas)
+{
+  if (leaderSamples.size() != curvilinearAbscissas.size()) {
+    throw std::runtime_error("Leader trail archive: samples and abscissas sizes differ");
+  }
+
+  // each call starts a new chunk, a chunk is also split when a delta overflows
+  const size_t firstNewChunkIndex = chunks_.size();
+  Chunk * chunk = nullptr;
+  int64_t previousX = 0;
+  int64_t previousY = 0;
+  int64_t previousCurvilinearAbscissa = 0;
+  int64_t previousStamp = 0;
+
+  for (size_t n = 0; n < leaderSamples.size(); ++n) {
+    const LeaderSample & leaderSample = leaderSamples[n];
+
+    if (chunk != nullptr) {
+      const Eigen::Vector2d shift = leaderSample.position - chunk->firstLeaderSample.position;
+      const int64_t x = quantize(shift.x(), POSITION_QUANTIZATION_STEP);
+      const int64_t y = quantize(shift.y(), POSITION_QUANTIZATION_STEP);
+      // timeline values are rounded down so restored values never pass the next ones
+      const int64_t curvilinearAbscissa = static_cast<int64_t>(std::floor(
+          (curvilinearAbscissas[n] - chunk->firstCurvilinearAbscissa) /
+          CURVILINEAR_ABSCISSA_QUANTIZATION_STEP));
+      const int64_t stampShift =
+        leaderSample.stamp.count() - chunk->firstLeaderSample.stamp.count();
+      const int64_t stamp = stampShift >= 0 ? stampShift / STAMP_QUANTIZATION_STEP : -1;
+      const int64_t speed = std::clamp<int64_t>(
+        quantize(leaderSample.speed, SPEED_QUANTIZATION_STEP),
+        0, std::numeric_limits<uint16_t>::max());
+
+      if (fits<int16_t>(x - previousX) &&
+        fits<int16_t>(y - previousY) &&
+        fits<uint16_t>(curvilinearAbscissa - previousCurvilinearAbscissa) &&
+        fits<uint32_t>(stamp - previousStamp))
+      {
+        chunk->deltas.push_back(
+          {static_cast<int16_t>(x - previousX),
+            static_cast<int16_t>(y - previousY),
+            static_cast<uint16_t>(curvilinearAbscissa - previousCurvilinearAbscissa),
+            static_cast<uint16_t>(speed),
+            static_cast<uint32_t>(stamp - previousStamp)});
+
+        const Eigen::Vector2d position = chunk->firstLeaderSample.position +
+          POSITION_QUANTIZATION_STEP * Eigen::Vector2d(x, y);
+        chunk->minimalPosition = chunk->minimalPosition.cwiseMin(position);
+        chunk->maximalPosition = chunk->maximalPosition.cwiseMax(position);
+
+        previousX = x;
+        previousY = y;
+        previousCurvilinearAbscissa = curvilinearAbscissa;
+        previousStamp = stamp;
+        continue;
+      }
+    }
+
+    chunks_.push_back(
+      {leaderSample,
+        curvilinearAbscissas[n],
+        leaderSample.position,
+        leaderSample.position,
+        {},
+        0});
+    chunk = &chunks_.back();
+    chunk->deltas.reserve(leaderSamples.size() - n - 1);
+    previousX = 0;
+    previousY = 0;
+    previousCurvilinearAbscissa = 0;
+    previousStamp = 0;
+  }
+
+  for (size_t n = firstNewChunkIndex; n < chunks_.size(); ++n) {
+    chunks_[n].deltas.shrink_to_fit();
+  }
+  size_ += leaderSamples.size();
+  enforceMaximalMemoryUsage_();
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::enforceMaximalMemoryUsage_()
+{
+  while (!chunks_.empty() && getMemoryUsage() > maximalMemoryUsage_) {
+    auto decimable = std::find_if(
+      chunks_.begin(), chunks_.end(), [](const Chunk & chunk) {
+        return chunk.decimationLevel < MAXIMAL_DECIMATION_LEVEL && chunk.deltas.size() > 1;
+      });
+
+    // newest chunk keeps its resolution as long as older ones can be dropped instead
+    const bool isNewest = decimable != chunks_.end() && std::next(decimable) == chunks_.end();
+    if (decimable != chunks_.end() && (!isNewest || chunks_.size() == 1)) {
+      size_ -= decimable->deltas.size();
+      decimate_(*decimable);
+      size_ += decimable->deltas.size();
+    } else {
+      size_ -= chunks_.front().deltas.size() + 1;
+      chunks_.erase(chunks_.begin());
+      chunks_.shrink_to_fit();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::decimate_(Chunk & chunk)
+{
+  // deltas are merged by pairs so every other sample is removed, a pair is kept as is
+  // when its sum overflows and the last delta is kept alone to keep the chunk end
+  std::vector<Delta> deltas;
+  deltas.reserve(chunk.deltas.size() / 2 + 1);
+  size_t n = 0;
+  for (; n + 1 < chunk.deltas.size(); n += 2) {
+    const Delta & first = chunk.deltas[n];
+    const Delta & second = chunk.deltas[n + 1];
+    const int64_t x = static_cast<int64_t>(first.x) + second.x;
+    const int64_t y = static_cast<int64_t>(first.y) + second.y;
+    const int64_t curvilinearAbscissa =
+      static_cast<int64_t>(first.curvilinearAbscissa) + second.curvilinearAbscissa;
+    const int64_t stamp = static_cast<int64_t>(first.stamp) + second.stamp;
+
+    if (fits<int16_t>(x) &&
+      fits<int16_t>(y) &&
+      fits<uint16_t>(curvilinearAbscissa) &&
+      fits<uint32_t>(stamp))
+    {
+      deltas.push_back(
+        {static_cast<int16_t>(x),
+          static_cast<int16_t>(y),
+          static_cast<uint16_t>(curvilinearAbscissa),
+          second.speed,
+          static_cast<uint32_t>(stamp)});
+    } else {
+      deltas.push_back(first);
+      deltas.push_back(second);
+    }
+  }
+  if (n < chunk.deltas.size()) {
+    deltas.push_back(chunk.deltas[n]);
+  }
+
+  deltas.shrink_to_fit();
+  chunk.deltas = std::move(deltas);
+  ++chunk.decimationLevel;
+}
+
+//-----------------------------------------------------------------------------
+bool LeaderTrailArchive::restore(
+  const Eigen::Vector2d & position,
+  const double & researchRadius,
+  std::vector<LeaderSample> & leaderSamples,
+  std::vector<double> & curvilinearAbscissas)
+{
+  leaderSamples.clear();
+  curvilinearAbscissas.clear();
+
+  auto reached = std::find_if(
+    chunks_.rbegin(), chunks_.rend(), [&](const Chunk & chunk) {
+      const Eigen::Vector2d closestPosition =
+      position.cwiseMax(chunk.minimalPosition).cwiseMin(chunk.maximalPosition);
+      return (position - closestPosition).norm() <= researchRadius;
+    });
+
+  if (reached == chunks_.rend()) {
+    return false;
+  }
+
+  auto first = std::prev(reached.base());
+  for (auto it = first; it != chunks_.end(); ++it) {
+    decode_(*it, leaderSamples, curvilinearAbscissas);
+  }
+  size_ -= leaderSamples.size();
+  chunks_.erase(first, chunks_.end());
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::decode(
+  std::vector<LeaderSample> & leaderSamples,
+  std::vector<double> & curvilinearAbscissas) const
+{
+  leaderSamples.clear();
+  curvilinearAbscissas.clear();
+  leaderSamples.reserve(size_);
+  curvilinearAbscissas.reserve(size_);
+  for (const auto & chunk : chunks_) {
+    decode_(chunk, leaderSamples, curvilinearAbscissas);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::decode_(
+  const Chunk & chunk,
+  std::vector<LeaderSample> & leaderSamples,
+  std::vector<double> & curvilinearAbscissas)
+{
+  leaderSamples.push_back(chunk.firstLeaderSample);
+  curvilinearAbscissas.push_back(chunk.firstCurvilinearAbscissa);
+
+  int64_t x = 0;
+  int64_t y = 0;
+  int64_t curvilinearAbscissa = 0;
+  int64_t stamp = 0;
+  for (const auto & delta : chunk.deltas) {
+    x += delta.x;
+    y += delta.y;
+    curvilinearAbscissa += delta.curvilinearAbscissa;
+    stamp += delta.stamp;
+
+    leaderSamples.push_back(
+      {chunk.firstLeaderSample.position + POSITION_QUANTIZATION_STEP * Eigen::Vector2d(x, y),
+        Duration(chunk.firstLeaderSample.stamp.count() + stamp * STAMP_QUANTIZATION_STEP),
+        delta.speed * SPEED_QUANTIZATION_STEP});
+    curvilinearAbscissas.push_back(
+      chunk.firstCurvilinearAbscissa +
+      curvilinearAbscissa * CURVILINEAR_ABSCISSA_QUANTIZATION_STEP);
+  }
+}
+
+//-----------------------------------------------------------------------------
+size_t LeaderTrailArchive::size() const
+{
+  return size_;
+}
+
+//-----------------------------------------------------------------------------
+bool LeaderTrailArchive::empty() const
+{
+  return size_ == 0;
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailArchive::clear()
+{
+  chunks_.clear();
+  size_ = 0;
+}
+
+//-----------------------------------------------------------------------------
+size_t LeaderTrailArchive::getMemoryUsage() const
+{
+  size_t memoryUsage = sizeof(*this) + chunks_.capacity() * sizeof(Chunk);
+  for (const auto & chunk : chunks_) {
+    memoryUsage += chunk.deltas.capacity() * sizeof(Delta);
+  }
+  return memoryUsage;
+}
+
+}  // namespace core
+}  // namespace romea
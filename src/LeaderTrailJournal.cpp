@@ -0,0 +1,350 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/LeaderTrailJournal.hpp"
+
+namespace
+{
+const char MAGIC[4] = {'R', 'P', 'M', 'J'};
+const uint32_t VERSION = 3;
+const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(VERSION);
+
+// version 1 records are version 2 records without kind, they are all way points.
+// From version 3 each record starts with its kind, followed by a payload of that kind
+enum RecordKind : uint8_t
+{
+  WAY_POINT = 0,
+  PENDING_SAMPLE = 1,
+  MATCHING_STATE = 2
+};
+
+#pragma pack(push, 1)
+struct LegacyRecord
+{
+  double x;
+  double y;
+  int64_t stamp;
+  float speed;
+  uint8_t kind;
+};
+
+struct SampleRecord
+{
+  double x;
+  double y;
+  int64_t stamp;
+  float speed;
+};
+
+struct StateRecord
+{
+  uint64_t numberOfSkippedResearches;
+  uint8_t hasMatchedPoint;
+  double x;
+  double y;
+  double course;
+  double curvature;
+  double dotCurvature;
+  double curvilinearAbscissa;
+  double lateralDeviation;
+  double courseDeviation;
+  uint64_t sectionIndex;
+  uint64_t curveIndex;
+};
+#pragma pack(pop)
+
+void writeHeader(std::ofstream & file)
+{
+  file.write(MAGIC, sizeof(MAGIC));
+  file.write(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION));
+}
+
+// version of an existing journal, empty when its header is missing or torn
+std::optional<uint32_t> readVersion(std::ifstream & file, const std::string & filename)
+{
+  char magic[sizeof(MAGIC)];
+  uint32_t version;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  if (!file) {
+    return std::nullopt;
+  }
+  if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version == 0 || version > VERSION) {
+    throw std::runtime_error(filename + " is not a leader trail journal");
+  }
+  return version;
+}
+
+void writeRecord(
+  std::ofstream & file,
+  const romea::core::LeaderSample & leaderSample,
+  const RecordKind & kind)
+{
+  SampleRecord record{
+    leaderSample.position.x(),
+    leaderSample.position.y(),
+    leaderSample.stamp.count(),
+    static_cast<float>(leaderSample.speed)};
+  file.put(static_cast<char>(kind));
+  file.write(reinterpret_cast<const char *>(&record), sizeof(SampleRecord));
+}
+
+void writeRecord(std::ofstream & file, const romea::core::LeaderTrailState & state)
+{
+  StateRecord record{};
+  record.numberOfSkippedResearches = state.numberOfSkippedResearches;
+  if (state.matchedPoint.has_value()) {
+    const auto & matchedPoint = *state.matchedPoint;
+    record.hasMatchedPoint = 1;
+    record.x = matchedPoint.pathPosture.position.x();
+    record.y = matchedPoint.pathPosture.position.y();
+    record.course = matchedPoint.pathPosture.course;
+    record.curvature = matchedPoint.pathPosture.curvature;
+    record.dotCurvature = matchedPoint.pathPosture.dotCurvature;
+    record.curvilinearAbscissa = matchedPoint.frenetPose.curvilinearAbscissa;
+    record.lateralDeviation = matchedPoint.frenetPose.lateralDeviation;
+    record.courseDeviation = matchedPoint.frenetPose.courseDeviation;
+    record.sectionIndex = matchedPoint.sectionIndex;
+    record.curveIndex = matchedPoint.curveIndex;
+  }
+  file.put(static_cast<char>(MATCHING_STATE));
+  file.write(reinterpret_cast<const char *>(&record), sizeof(StateRecord));
+}
+
+romea::core::LeaderSample toLeaderSample(
+  const double & x,
+  const double & y,
+  const int64_t & stamp,
+  const float & speed)
+{
+  return {Eigen::Vector2d(x, y), romea::core::Duration(stamp), static_cast<double>(speed)};
+}
+
+romea::core::LeaderTrailState toLeaderTrailState(const StateRecord & record)
+{
+  romea::core::LeaderTrailState state{std::nullopt, record.numberOfSkippedResearches};
+  if (record.hasMatchedPoint) {
+    romea::core::PathMatchedPoint2D matchedPoint;
+    matchedPoint.pathPosture.position = Eigen::Vector2d(record.x, record.y);
+    matchedPoint.pathPosture.course = record.course;
+    matchedPoint.pathPosture.curvature = record.curvature;
+    matchedPoint.pathPosture.dotCurvature = record.dotCurvature;
+    matchedPoint.frenetPose.curvilinearAbscissa = record.curvilinearAbscissa;
+    matchedPoint.frenetPose.lateralDeviation = record.lateralDeviation;
+    matchedPoint.frenetPose.courseDeviation = record.courseDeviation;
+    matchedPoint.sectionIndex = record.sectionIndex;
+    matchedPoint.curveIndex = record.curveIndex;
+    state.matchedPoint = matchedPoint;
+  }
+  return state;
+}
+
+void replaceFile(const std::string & temporaryFilename, const std::string & filename)
+{
+  if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(temporaryFilename.c_str());
+    throw std::runtime_error("Cannot replace leader trail journal " + filename);
+  }
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+LeaderTrailJournal::LeaderTrailJournal(const std::string & filename)
+: file_()
+{
+  // journals of a previous version are rewritten so that new records can be appended
+  std::optional<uint32_t> version;
+  {
+    std::ifstream file(filename, std::ios::binary);
+    if (file.is_open()) {
+      version = readVersion(file, filename);
+    }
+  }
+  if (version.has_value() && *version != VERSION) {
+    std::vector<LeaderSample> pendingLeaderSamples;
+    std::optional<LeaderTrailState> state;
+    auto leaderSamples = read(filename, pendingLeaderSamples, state);
+    write(filename, leaderSamples, pendingLeaderSamples, state);
+  }
+
+  file_.open(filename, std::ios::binary | std::ios::app);
+  if (!file_.is_open()) {
+    throw std::runtime_error("Cannot open leader trail journal " + filename);
+  }
+
+  // a header torn by a crash cannot be followed by any record, journal is restarted
+  if (file_.tellp() < static_cast<std::streamoff>(HEADER_SIZE)) {
+    file_.close();
+    file_.open(filename, std::ios::binary | std::ios::trunc);
+    writeHeader(file_);
+    file_.flush();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailJournal::append(const LeaderSample & leaderSample)
+{
+  writeRecord(file_, leaderSample, WAY_POINT);
+  file_.flush();
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailJournal::appendPendingSample(const LeaderSample & leaderSample)
+{
+  writeRecord(file_, leaderSample, PENDING_SAMPLE);
+  file_.flush();
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailJournal::appendState(const LeaderTrailState & state)
+{
+  writeRecord(file_, state);
+  file_.flush();
+}
+
+//-----------------------------------------------------------------------------
+std::vector<LeaderSample> LeaderTrailJournal::read(const std::string & filename)
+{
+  std::vector<LeaderSample> pendingLeaderSamples;
+  std::optional<LeaderTrailState> state;
+  return read(filename, pendingLeaderSamples, state);
+}
+
+//-----------------------------------------------------------------------------
+std::vector<LeaderSample> LeaderTrailJournal::read(
+  const std::string & filename,
+  std::vector<LeaderSample> & pendingLeaderSamples,
+  std::optional<LeaderTrailState> & state)
+{
+  std::vector<LeaderSample> leaderSamples;
+  pendingLeaderSamples.clear();
+  state.reset();
+
+  // a journal whose header is torn holds no record
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file.is_open() || file.tellg() < static_cast<std::streamoff>(HEADER_SIZE)) {
+    return leaderSamples;
+  }
+
+  const size_t size = static_cast<size_t>(file.tellg());
+  file.seekg(0);
+  const uint32_t version = *readVersion(file, filename);
+
+  // a record torn by a crash is the last one, reading stops there
+  size_t position = HEADER_SIZE;
+  while (position < size) {
+    RecordKind kind = WAY_POINT;
+    if (version >= 3) {
+      kind = static_cast<RecordKind>(file.get());
+      position += 1;
+    }
+
+    if (version < 3) {
+      const size_t recordSize =
+        version == 1 ? offsetof(LegacyRecord, kind) : sizeof(LegacyRecord);
+      LegacyRecord record;
+      record.kind = WAY_POINT;
+      if (size - position < recordSize ||
+        !file.read(reinterpret_cast<char *>(&record), recordSize))
+      {
+        break;
+      }
+      position += recordSize;
+      kind = static_cast<RecordKind>(record.kind);
+      auto & samples = kind == PENDING_SAMPLE ? pendingLeaderSamples : leaderSamples;
+      samples.push_back(toLeaderSample(record.x, record.y, record.stamp, record.speed));
+    } else if (kind == WAY_POINT || kind == PENDING_SAMPLE) {
+      SampleRecord record;
+      if (size - position < sizeof(SampleRecord) ||
+        !file.read(reinterpret_cast<char *>(&record), sizeof(SampleRecord)))
+      {
+        break;
+      }
+      position += sizeof(SampleRecord);
+      auto & samples = kind == PENDING_SAMPLE ? pendingLeaderSamples : leaderSamples;
+      samples.push_back(toLeaderSample(record.x, record.y, record.stamp, record.speed));
+    } else if (kind == MATCHING_STATE) {
+      StateRecord record;
+      if (size - position < sizeof(StateRecord) ||
+        !file.read(reinterpret_cast<char *>(&record), sizeof(StateRecord)))
+      {
+        break;
+      }
+      position += sizeof(StateRecord);
+      state = toLeaderTrailState(record);
+    } else {
+      break;
+    }
+  }
+
+  // samples pending before the last way point was kept are obsolete
+  if (!leaderSamples.empty()) {
+    const Duration lastStamp = leaderSamples.back().stamp;
+    pendingLeaderSamples.erase(
+      std::remove_if(
+        pendingLeaderSamples.begin(), pendingLeaderSamples.end(),
+        [&lastStamp](const LeaderSample & sample) {return sample.stamp <= lastStamp;}),
+      pendingLeaderSamples.end());
+  }
+  return leaderSamples;
+}
+
+//-----------------------------------------------------------------------------
+void LeaderTrailJournal::write(
+  const std::string & filename,
+  const std::vector<LeaderSample> & leaderSamples,
+  const std::vector<LeaderSample> & pendingLeaderSamples,
+  const std::optional<LeaderTrailState> & state)
+{
+  std::string temporaryFilename = filename + ".tmp";
+  {
+    std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+    writeHeader(file);
+    for (const auto & leaderSample : leaderSamples) {
+      writeRecord(file, leaderSample, WAY_POINT);
+    }
+    for (const auto & leaderSample : pendingLeaderSamples) {
+      writeRecord(file, leaderSample, PENDING_SAMPLE);
+    }
+    if (state.has_value()) {
+      writeRecord(file, *state);
+    }
+    if (!file) {
+      std::remove(temporaryFilename.c_str());
+      throw std::runtime_error("Cannot write leader trail journal " + filename);
+    }
+  }
+  replaceFile(temporaryFilename, filename);
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,187 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/LocalTangentPlaneConverter.hpp"
+
+namespace
+{
+// about 60 m on earth, small enough for finite differences of a smooth function
+const double DIFFERENTIATION_STEP = 1e-5;
+const size_t NUMBER_OF_CHECKED_POINTS = 64;
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+LocalTangentPlaneConverter::LocalTangentPlaneConverter(
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & maximalError)
+: enuConverter_(wgs84Anchor),
+  altitude_(wgs84Anchor.altitude),
+  maximalError_(maximalError),
+  centerLatitude_(wgs84Anchor.latitude),
+  centerLongitude_(wgs84Anchor.longitude),
+  value_(Eigen::Vector2d::Zero()),
+  dLatitude_(Eigen::Vector2d::Zero()),
+  dLongitude_(Eigen::Vector2d::Zero()),
+  dLatitude2_(Eigen::Vector2d::Zero()),
+  dLongitude2_(Eigen::Vector2d::Zero()),
+  dLatitudeLongitude_(Eigen::Vector2d::Zero()),
+  estimatedError_(0),
+  usedExactConversion_(false)
+{
+}
+
+//-----------------------------------------------------------------------------
+void LocalTangentPlaneConverter::toENU(
+  const std::vector<double> & latitudes,
+  const std::vector<double> & longitudes,
+  std::vector<double> & east,
+  std::vector<double> & north)
+{
+  if (latitudes.size() != longitudes.size()) {
+    throw std::invalid_argument("latitudes and longitudes must have the same size");
+  }
+
+  const size_t size = latitudes.size();
+  east.resize(size);
+  north.resize(size);
+  estimatedError_ = 0;
+  usedExactConversion_ = false;
+  if (size == 0) {
+    return;
+  }
+
+  auto [minLatitude, maxLatitude] = std::minmax_element(latitudes.begin(), latitudes.end());
+  auto [minLongitude, maxLongitude] = std::minmax_element(longitudes.begin(), longitudes.end());
+  expand_(
+    0.5 * (*minLatitude + *maxLatitude),
+    0.5 * (*minLongitude + *maxLongitude),
+    DIFFERENTIATION_STEP);
+
+  // error of a second order expansion is the largest on extent borders
+  std::vector<std::pair<double, double>> checkPoints;
+  for (double latitude : {*minLatitude, centerLatitude_, *maxLatitude}) {
+    for (double longitude : {*minLongitude, centerLongitude_, *maxLongitude}) {
+      checkPoints.emplace_back(latitude, longitude);
+    }
+  }
+  const size_t checkStep = std::max<size_t>(1, size / NUMBER_OF_CHECKED_POINTS);
+  for (size_t n = 0; n < size; n += checkStep) {
+    checkPoints.emplace_back(latitudes[n], longitudes[n]);
+  }
+
+  for (const auto & [latitude, longitude] : checkPoints) {
+    estimatedError_ = std::max(
+      estimatedError_,
+      (approximateToENU_(latitude, longitude) - exactToENU_(latitude, longitude)).norm());
+  }
+
+  if (estimatedError_ > maximalError_) {
+    usedExactConversion_ = true;
+    for (size_t n = 0; n < size; ++n) {
+      Eigen::Vector2d enu = exactToENU_(latitudes[n], longitudes[n]);
+      east[n] = enu.x();
+      north[n] = enu.y();
+    }
+    return;
+  }
+
+  // branch free loop on contiguous arrays, vectorized by the compiler
+  const double * latitude = latitudes.data();
+  const double * longitude = longitudes.data();
+  double * e = east.data();
+  double * n = north.data();
+  for (size_t i = 0; i < size; ++i) {
+    const double dlat = latitude[i] - centerLatitude_;
+    const double dlon = longitude[i] - centerLongitude_;
+    const double dlat2 = 0.5 * dlat * dlat;
+    const double dlon2 = 0.5 * dlon * dlon;
+    const double dlatlon = dlat * dlon;
+    e[i] = value_.x() + dLatitude_.x() * dlat + dLongitude_.x() * dlon +
+      dLatitude2_.x() * dlat2 + dLongitude2_.x() * dlon2 + dLatitudeLongitude_.x() * dlatlon;
+    n[i] = value_.y() + dLatitude_.y() * dlat + dLongitude_.y() * dlon +
+      dLatitude2_.y() * dlat2 + dLongitude2_.y() * dlon2 + dLatitudeLongitude_.y() * dlatlon;
+  }
+}
+
+//-----------------------------------------------------------------------------
+double LocalTangentPlaneConverter::getEstimatedError() const
+{
+  return estimatedError_;
+}
+
+//-----------------------------------------------------------------------------
+bool LocalTangentPlaneConverter::usedExactConversion() const
+{
+  return usedExactConversion_;
+}
+
+//-----------------------------------------------------------------------------
+Eigen::Vector2d LocalTangentPlaneConverter::exactToENU_(
+  const double & latitude,
+  const double & longitude) const
+{
+  return enuConverter_.toENU(makeGeodeticCoordinates(latitude, longitude, altitude_)).head<2>();
+}
+
+//-----------------------------------------------------------------------------
+void LocalTangentPlaneConverter::expand_(
+  const double & centerLatitude,
+  const double & centerLongitude,
+  const double & step)
+{
+  centerLatitude_ = centerLatitude;
+  centerLongitude_ = centerLongitude;
+
+  auto f = [&](const double & dlat, const double & dlon) {
+      return exactToENU_(centerLatitude + dlat * step, centerLongitude + dlon * step);
+    };
+
+  value_ = f(0, 0);
+  const Eigen::Vector2d north = f(1, 0);
+  const Eigen::Vector2d south = f(-1, 0);
+  const Eigen::Vector2d east = f(0, 1);
+  const Eigen::Vector2d west = f(0, -1);
+
+  dLatitude_ = (north - south) / (2 * step);
+  dLongitude_ = (east - west) / (2 * step);
+  dLatitude2_ = (north - 2 * value_ + south) / (step * step);
+  dLongitude2_ = (east - 2 * value_ + west) / (step * step);
+  dLatitudeLongitude_ = (f(1, 1) - f(1, -1) - f(-1, 1) + f(-1, -1)) / (4 * step * step);
+}
+
+//-----------------------------------------------------------------------------
+Eigen::Vector2d LocalTangentPlaneConverter::approximateToENU_(
+  const double & latitude,
+  const double & longitude) const
+{
+  const double dlat = latitude - centerLatitude_;
+  const double dlon = longitude - centerLongitude_;
+  return value_ + dLatitude_ * dlat + dLongitude_ * dlon +
+         dLatitude2_ * (0.5 * dlat * dlat) + dLongitude2_ * (0.5 * dlon * dlon) +
+         dLatitudeLongitude_ * (dlat * dlon);
+}
+
+}  // namespace core
+}  // namespace romea
@@ -13,12 +13,22 @@
 // limitations under the License.
 
 // std
+#include <algorithm>
+#include <filesystem>
+#include <memory>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
 
 // romea
 #include "romea_core_common/math/EulerAngles.hpp"
 #include "romea_core_path/PathSectionMatching2D.hpp"
 #include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+#include "romea_core_path_matching/PathMatchingT.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
 
 namespace
 {
@@ -55,15 +65,47 @@ OnTheFlyPathMatching::OnTheFlyPathMatching(
   const double & maximalResearchRadius,
   const double & interpolationWindowLength,
   const double & minimalDistanceBetweenTwoPoints,
-  const double & minimalVehicleSpeedToInsertPoint)
+  const double & minimalVehicleSpeedToInsertPoint,
+  const double & maximalLateralError,
+  const DiagnosticsMode & diagnosticsMode)
 : predictionTimeHorizon_(predictionTimeHorizon),
   maximalResearchRadius_(maximalResearchRadius),
   interpolationWindowLength_(interpolationWindowLength),
   minimalDistanceBetweenTwoPoints_(minimalDistanceBetweenTwoPoints),
   minimalVehicleSpeedToInsertPoint_(minimalVehicleSpeedToInsertPoint),
+  previousLeaderPosition_(),
+  pathSimplifier_(),
+  pendingLeaderSamples_(),
   pathSection_(interpolationWindowLength),
-  matchedPoint_()
+  leaderTimeline_(),
+  journal_(),
+  journalFilename_(),
+  journaledCurveIndex_(),
+  archivingDistance_(),
+  trailArchive_(),
+  matchedPoint_(),
+  changeDetector_(),
+  numberOfSkippedResearches_(0),
+  diagnostics_(makeDiagnostics_(diagnosticsMode))
 {
+  // kept points must stay close enough to fit path curves on interpolation windows
+  if (maximalLateralError > 0) {
+    pathSimplifier_.emplace(maximalLateralError, 0.5 * interpolationWindowLength);
+  }
+}
+
+//-----------------------------------------------------------------------------
+OnTheFlyPathMatching::Diagnostics OnTheFlyPathMatching::makeDiagnostics_(
+  const DiagnosticsMode & diagnosticsMode)
+{
+  switch (diagnosticsMode) {
+    case DiagnosticsMode::DEFERRED:
+      return Diagnostics(std::in_place_type<DeferredOnTheFlyPathMatchingDiagnostic>);
+    case DiagnosticsMode::DISABLED:
+      return Diagnostics(std::in_place_type<NoDiagnostics>);
+    default:
+      return Diagnostics(std::in_place_type<OnTheFlyPathMatchingDiagnostic>);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -72,73 +114,328 @@ bool OnTheFlyPathMatching::updatePath(
   const Pose2D & leaderVehiclePose,
   const Twist2D & leaderVehicleTwist)
 {
-  diagnostics_.updateLeaderLocalisationRate(stamp);
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("OnTheFlyPathMatching::updatePath");
+  std::visit(
+    [&stamp](auto & diagnostics) {diagnostics.updateLeaderLocalisationRate(stamp);},
+    diagnostics_);
   if (travelledDistance_(leaderVehiclePose) > minimalDistanceBetweenTwoPoints_ &&
     leaderVehicleSpeed_(leaderVehicleTwist) > minimalVehicleSpeedToInsertPoint_)
   {
-    pathSection_.addWayPoint(PathWayPoint2D(leaderVehiclePose.position));
-    return true;
+    return insertWayPoint_(
+      {leaderVehiclePose.position, stamp, leaderVehicleSpeed_(leaderVehicleTwist)});
   } else {
     return false;
   }
 }
 
+//-----------------------------------------------------------------------------
+bool OnTheFlyPathMatching::insertWayPoint_(const LeaderSample & leaderSample)
+{
+  if (!pathSimplifier_.has_value()) {
+    addWayPoint_(leaderSample);
+    return true;
+  }
+
+  pendingLeaderSamples_.push_back(leaderSample);
+  if (journal_) {
+    journal_->appendPendingSample(leaderSample);
+  }
+
+  if (!pathSimplifier_->update(leaderSample.position).has_value()) {
+    return false;
+  }
+
+  // kept sample is the one just before the samples still pending in simplifier
+  size_t keptIndex = pendingLeaderSamples_.size() - pathSimplifier_->getPendingPoints().size() - 1;
+  addWayPoint_(pendingLeaderSamples_[keptIndex]);
+  pendingLeaderSamples_.erase(
+    pendingLeaderSamples_.begin(),
+    pendingLeaderSamples_.begin() + keptIndex + 1);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::addWayPoint_(const LeaderSample & leaderSample)
+{
+  double curvilinearAbscissa = 0;
+  if (!leaderTimeline_.empty()) {
+    Eigen::Vector2d lastPosition(pathSection_.getX().back(), pathSection_.getY().back());
+    curvilinearAbscissa = leaderTimeline_.getCurvilinearAbscissas().back() +
+      (leaderSample.position - lastPosition).norm();
+  }
+
+  pathSection_.addWayPoint(PathWayPoint2D(leaderSample.position));
+  leaderTimeline_.append(curvilinearAbscissa, leaderSample.stamp, leaderSample.speed);
+
+  if (journal_) {
+    journal_->append(leaderSample);
+  }
+}
+
 //-----------------------------------------------------------------------------
 std::optional<PathMatchedPoint2D> OnTheFlyPathMatching::match(
   const Duration & stamp,
   const core::Pose2D & vehiclePose,
   const core::Twist2D & vehicleTwist)
 {
-  diagnostics_.updateFollowerLocalisationRate(stamp);
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("OnTheFlyPathMatching::match");
+  std::visit(
+    [&stamp](auto & diagnostics) {diagnostics.updateFollowerLocalisationRate(stamp);},
+    diagnostics_);
+
+  // research is skipped only if the matched point stays on its curve
+  std::optional<PathMatchedPoint2D> extrapolatedPoint;
+  if (matchedPoint_.has_value() &&
+    !changeDetector_.hasChanged(vehiclePose, vehicleTwist, predictionTimeHorizon_))
+  {
+    extrapolatedPoint = extrapolateMatchedPoint(pathSection_, *matchedPoint_, vehiclePose);
+  }
 
-  if (pathSection_.getLength() > 2) {
+  if (extrapolatedPoint.has_value()) {
+    matchedPoint_ = extrapolatedPoint;
+    ++numberOfSkippedResearches_;
+  } else if (pathSection_.getLength() > 2) {
     tryMatchOnFullPath_(vehiclePose, vehicleTwist);
 
-    if (!matchedPoint_.has_value()) {
+    if (!matchedPoint_.has_value() && restoreArchivedTrail_(vehiclePose)) {
+      tryMatchOnFullPath_(vehiclePose, vehicleTwist);
+    }
+
+    // matches on the first point are redone as the trail may reach the follower meanwhile
+    if (matchedPoint_.has_value()) {
+      changeDetector_.setReference(vehiclePose, vehicleTwist, predictionTimeHorizon_);
+    } else {
+      changeDetector_.reset();
+    }
+
+    // first point of the path section is the start of the trail only if nothing is archived
+    if (!matchedPoint_.has_value() && trailArchive_.empty()) {
       tryMatchOnFirstPoint_(vehiclePose, vehicleTwist);
     }
+
+    if (matchedPoint_.has_value() && archivingDistance_.has_value()) {
+      archiveTrail_();
+    }
+  }
+  std::visit(
+    [status = matchedPoint_.has_value()](auto & diagnostics) {
+      diagnostics.updatePathMatchingStatus(status);
+    }, diagnostics_);
+  journalState_();
+
+  // matched point is kept relative to the path section to be used as tracking seed
+  std::optional<PathMatchedPoint2D> matchedPoint = matchedPoint_;
+  if (matchedPoint.has_value()) {
+    matchedPoint->frenetPose.curvilinearAbscissa += archivedTrailLength_();
   }
-  diagnostics_.updatePathMatchingStatus(matchedPoint_.has_value());
-  return matchedPoint_;
+  return matchedPoint;
 }
 
 //-----------------------------------------------------------------------------
 DiagnosticReport OnTheFlyPathMatching::getReport(const Duration & stamp)
 {
-  return diagnostics_.makeReport(stamp);
+  return std::visit(
+    [&stamp](auto & diagnostics) {return diagnostics.makeReport(stamp);}, diagnostics_);
+}
+
+//-----------------------------------------------------------------------------
+std::optional<Duration> OnTheFlyPathMatching::getLeaderStamp(
+  const PathMatchedPoint2D & matchedPoint) const
+{
+  return leaderTimeline_.getStamp(matchedPoint.frenetPose.curvilinearAbscissa);
+}
+
+//-----------------------------------------------------------------------------
+std::optional<double> OnTheFlyPathMatching::getLeaderSpeed(
+  const PathMatchedPoint2D & matchedPoint) const
+{
+  return leaderTimeline_.getSpeed(matchedPoint.frenetPose.curvilinearAbscissa);
+}
+
+//-----------------------------------------------------------------------------
+std::optional<double> OnTheFlyPathMatching::getLeaderCurvilinearAbscissa(
+  const Duration & stamp) const
+{
+  return leaderTimeline_.getCurvilinearAbscissa(stamp);
+}
+
+//-----------------------------------------------------------------------------
+const LeaderTimeline & OnTheFlyPathMatching::getLeaderTimeline() const
+{
+  return leaderTimeline_;
+}
+
+//-----------------------------------------------------------------------------
+const LeaderTrailArchive & OnTheFlyPathMatching::getTrailArchive() const
+{
+  return trailArchive_;
 }
 
 //-----------------------------------------------------------------------------
 void OnTheFlyPathMatching::reset()
 {
   matchedPoint_.reset();
+  changeDetector_.reset();
 }
 
 //-----------------------------------------------------------------------------
-void OnTheFlyPathMatching::tryMatchOnFullPath_(
-  const core::Pose2D & followerVehiclePose,
-  const core::Twist2D & followerVehicleTwist)
+void OnTheFlyPathMatching::enableChangeDetection(const PoseChangeThresholds & thresholds)
 {
-  double followerVehicleSpeed = followerVehicleTwist.linearSpeeds.x();
+  changeDetector_ = PoseChangeDetector(thresholds);
+}
 
-  if (matchedPoint_.has_value()) {
-    matchedPoint_ = romea::core::match(
-      pathSection_,
-      followerVehiclePose,
-      followerVehicleSpeed,
-      *matchedPoint_,
-      10,
-      predictionTimeHorizon_,
-      maximalResearchRadius_);
+//-----------------------------------------------------------------------------
+size_t OnTheFlyPathMatching::getNumberOfSkippedResearches() const
+{
+  return numberOfSkippedResearches_;
+}
 
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::enableJournal(const std::string & filename)
+{
+  if (!leaderTimeline_.empty() || !trailArchive_.empty() || !pendingLeaderSamples_.empty()) {
+    throw std::runtime_error("Leader trail journal must be enabled before the first path update");
+  }
+
+  journal_.reset();
+
+  std::vector<LeaderSample> pendingLeaderSamples;
+  std::optional<LeaderTrailState> state;
+  auto leaderSamples = LeaderTrailJournal::read(filename, pendingLeaderSamples, state);
+  for (const auto & leaderSample : leaderSamples) {
+    addWayPoint_(leaderSample);
+  }
+
+  if (!leaderSamples.empty()) {
+    previousLeaderPosition_ = leaderSamples.back().position;
+  }
+
+  // pending samples are only meaningful for a simplifier resuming after the last way point
+  if (pathSimplifier_.has_value() && !leaderSamples.empty()) {
+    std::vector<Eigen::Vector2d> pendingPoints;
+    pendingPoints.reserve(pendingLeaderSamples.size());
+    for (const auto & leaderSample : pendingLeaderSamples) {
+      pendingPoints.push_back(leaderSample.position);
+    }
+    pathSimplifier_->restore(leaderSamples.back().position, pendingPoints);
+    pendingLeaderSamples_ = pendingLeaderSamples;
+
+    if (!pendingLeaderSamples.empty()) {
+      previousLeaderPosition_ = pendingLeaderSamples.back().position;
+    }
   } else {
-    matchedPoint_ = romea::core::match(
-      pathSection_,
-      followerVehiclePose,
-      followerVehicleSpeed,
-      predictionTimeHorizon_,
-      maximalResearchRadius_);
+    pendingLeaderSamples.clear();
   }
+
+  // whole trail is restored in path section, state abscissa is given from its start and
+  // its curve is found again from it
+  if (state.has_value()) {
+    matchedPoint_ = state->matchedPoint;
+    numberOfSkippedResearches_ = state->numberOfSkippedResearches;
+    if (matchedPoint_.has_value() && !leaderTimeline_.empty()) {
+      matchedPoint_->curveIndex = nearestWayPointIndex_(
+        matchedPoint_->frenetPose.curvilinearAbscissa);
+    }
+  }
+
+  // compaction drops a record possibly torn by a crash before appending again
+  LeaderTrailJournal::write(filename, leaderSamples, pendingLeaderSamples, state);
+  journal_ = std::make_unique<LeaderTrailJournal>(filename);
+  journalFilename_ = filename;
+  journaledCurveIndex_ = matchedPoint_.has_value() ?
+    std::optional<size_t>(matchedPoint_->curveIndex) : std::nullopt;
+}
+
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::writeSnapshot(const std::string & filename)
+{
+  const auto & X = pathSection_.getX();
+  const auto & Y = pathSection_.getY();
+  const auto & stamps = leaderTimeline_.getStamps();
+  const auto & speeds = leaderTimeline_.getSpeeds();
+
+  std::vector<LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  trailArchive_.decode(leaderSamples, curvilinearAbscissas);
+
+  leaderSamples.reserve(leaderSamples.size() + leaderTimeline_.size());
+  for (size_t n = 0; n < leaderTimeline_.size(); ++n) {
+    leaderSamples.push_back({Eigen::Vector2d(X[n], Y[n]), Duration(stamps[n]), speeds[n]});
+  }
+  LeaderTrailJournal::write(filename, leaderSamples, pendingLeaderSamples_, makeTrailState_());
+
+  // journal replaced by the snapshot is opened again, appending to the old one would be lost
+  std::error_code error;
+  if (journal_ && std::filesystem::equivalent(filename, journalFilename_, error)) {
+    journal_ = std::make_unique<LeaderTrailJournal>(filename);
+  }
+}
+
+//-----------------------------------------------------------------------------
+LeaderTrailState OnTheFlyPathMatching::makeTrailState_() const
+{
+  LeaderTrailState state{matchedPoint_, numberOfSkippedResearches_};
+  if (state.matchedPoint.has_value()) {
+    state.matchedPoint->frenetPose.curvilinearAbscissa += archivedTrailLength_();
+  }
+  return state;
+}
+
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::journalState_()
+{
+  // extrapolations and researches along the same curve are not worth a record
+  const std::optional<size_t> curveIndex = matchedPoint_.has_value() ?
+    std::optional<size_t>(matchedPoint_->curveIndex) : std::nullopt;
+  if (journal_ && curveIndex != journaledCurveIndex_) {
+    journal_->appendState(makeTrailState_());
+    journaledCurveIndex_ = curveIndex;
+  }
+}
+
+//-----------------------------------------------------------------------------
+size_t OnTheFlyPathMatching::nearestWayPointIndex_(const double & curvilinearAbscissa) const
+{
+  const auto & curvilinearAbscissas = leaderTimeline_.getCurvilinearAbscissas();
+  const size_t index = std::distance(
+    curvilinearAbscissas.begin(),
+    std::upper_bound(
+      curvilinearAbscissas.begin(), curvilinearAbscissas.end(), curvilinearAbscissa));
+
+  if (index == 0) {
+    return 0;
+  }
+  if (index == curvilinearAbscissas.size() ||
+    curvilinearAbscissa - curvilinearAbscissas[index - 1] <
+    curvilinearAbscissas[index] - curvilinearAbscissa)
+  {
+    return index - 1;
+  }
+  return index;
+}
+
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::enableTrailArchiving(
+  const double & archivingDistance,
+  const size_t & maximalArchiveMemoryUsage)
+{
+  archivingDistance_ = std::max(archivingDistance, maximalResearchRadius_);
+  trailArchive_.setMaximalMemoryUsage(maximalArchiveMemoryUsage);
+}
+
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::tryMatchOnFullPath_(
+  const core::Pose2D & followerVehiclePose,
+  const core::Twist2D & followerVehicleTwist)
+{
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("OnTheFlyPathMatching::tryMatchOnFullPath_");
+  matchOnPathSection<Tracking<10>>(
+    pathSection_,
+    followerVehiclePose,
+    followerVehicleTwist.linearSpeeds.x(),
+    predictionTimeHorizon_,
+    maximalResearchRadius_,
+    matchedPoint_);
 }
 
 //-----------------------------------------------------------------------------
@@ -146,6 +443,7 @@ void OnTheFlyPathMatching::tryMatchOnFirstPoint_(
   const core::Pose2D & followerVehiclePose,
   const core::Twist2D & /*followerVehicleTwist*/)
 {
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("OnTheFlyPathMatching::tryMatchOnFirstPoint_");
   Eigen::Vector2d firstPathPosition(pathSection_.getX()[0], pathSection_.getX()[1]);
   Eigen::Vector2d directionToReach = followerVehiclePose.position - firstPathPosition;
   if ((directionToReach).norm() < maximalResearchRadius_) {
@@ -157,9 +455,11 @@ void OnTheFlyPathMatching::tryMatchOnFirstPoint_(
 double OnTheFlyPathMatching::travelledDistance_(const core::Pose2D & leaderVehiclePose)
 {
   const Eigen::Vector2d & leaderPosition = leaderVehiclePose.position;
-  static Eigen::Vector2d previousLeaderPosition = leaderPosition;
-  double distance = (leaderPosition - previousLeaderPosition).norm();
-  previousLeaderPosition = leaderPosition;
+  if (!previousLeaderPosition_.has_value()) {
+    previousLeaderPosition_ = leaderPosition;
+  }
+  double distance = (leaderPosition - *previousLeaderPosition_).norm();
+  previousLeaderPosition_ = leaderPosition;
   return distance;
 }
 
@@ -169,5 +469,93 @@ double OnTheFlyPathMatching::leaderVehicleSpeed_(const core::Twist2D & leaderVeh
   return leaderVehicleTwist.linearSpeeds.norm();
 }
 
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::archiveTrail_()
+{
+  const auto & curvilinearAbscissas = leaderTimeline_.getCurvilinearAbscissas();
+  const double archivingAbscissa = curvilinearAbscissas.front() +
+    matchedPoint_->frenetPose.curvilinearAbscissa - *archivingDistance_;
+
+  const size_t numberOfArchivedWayPoints = std::distance(
+    curvilinearAbscissas.begin(),
+    std::upper_bound(curvilinearAbscissas.begin(), curvilinearAbscissas.end(), archivingAbscissa));
+
+  if (numberOfArchivedWayPoints < MINIMAL_NUMBER_OF_ARCHIVED_WAY_POINTS ||
+    numberOfArchivedWayPoints + 2 > leaderTimeline_.size())
+  {
+    return;
+  }
+
+  const auto & X = pathSection_.getX();
+  const auto & Y = pathSection_.getY();
+  const auto & stamps = leaderTimeline_.getStamps();
+  const auto & speeds = leaderTimeline_.getSpeeds();
+
+  std::vector<LeaderSample> leaderSamples;
+  leaderSamples.reserve(numberOfArchivedWayPoints);
+  for (size_t n = 0; n < numberOfArchivedWayPoints; ++n) {
+    leaderSamples.push_back({Eigen::Vector2d(X[n], Y[n]), Duration(stamps[n]), speeds[n]});
+  }
+  trailArchive_.archive(
+    leaderSamples,
+    std::vector<double>(
+      curvilinearAbscissas.begin(), curvilinearAbscissas.begin() + numberOfArchivedWayPoints));
+
+  const double archivedLength =
+    curvilinearAbscissas[numberOfArchivedWayPoints] - curvilinearAbscissas.front();
+  rebuildPathSection_({}, numberOfArchivedWayPoints);
+  leaderTimeline_.eraseFront(numberOfArchivedWayPoints);
+
+  // tracking seed is moved to the rebuilt path section
+  matchedPoint_->frenetPose.curvilinearAbscissa -= archivedLength;
+  matchedPoint_->curveIndex -= std::min(matchedPoint_->curveIndex, numberOfArchivedWayPoints);
+}
+
+//-----------------------------------------------------------------------------
+bool OnTheFlyPathMatching::restoreArchivedTrail_(const Pose2D & followerVehiclePose)
+{
+  std::vector<LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  if (trailArchive_.empty() ||
+    !trailArchive_.restore(
+      followerVehiclePose.position, maximalResearchRadius_, leaderSamples, curvilinearAbscissas))
+  {
+    return false;
+  }
+
+  LeaderTimeline restoredTimeline;
+  for (size_t n = 0; n < leaderSamples.size(); ++n) {
+    restoredTimeline.append(
+      curvilinearAbscissas[n], leaderSamples[n].stamp, leaderSamples[n].speed);
+  }
+  leaderTimeline_.prepend(restoredTimeline);
+  rebuildPathSection_(leaderSamples, 0);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void OnTheFlyPathMatching::rebuildPathSection_(
+  const std::vector<LeaderSample> & restoredLeaderSamples,
+  const size_t & firstKeptWayPointIndex)
+{
+  PathSection2D pathSection(interpolationWindowLength_);
+  for (const auto & leaderSample : restoredLeaderSamples) {
+    pathSection.addWayPoint(PathWayPoint2D(leaderSample.position));
+  }
+
+  const auto & X = pathSection_.getX();
+  const auto & Y = pathSection_.getY();
+  for (size_t n = firstKeptWayPointIndex; n < X.size(); ++n) {
+    pathSection.addWayPoint(PathWayPoint2D(Eigen::Vector2d(X[n], Y[n])));
+  }
+  pathSection_ = std::move(pathSection);
+}
+
+//-----------------------------------------------------------------------------
+double OnTheFlyPathMatching::archivedTrailLength_() const
+{
+  return leaderTimeline_.empty() ? 0. : leaderTimeline_.getCurvilinearAbscissas().front();
+}
+
 }  // namespace core
 }  // namespace romea
@@ -19,6 +19,7 @@
 
 // romea
 #include "romea_core_path_matching/OnTheFlyPathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
 
 namespace
 {
@@ -74,6 +75,7 @@ void OnTheFlyPathMatchingDiagnostic::updatePathMatchingStatus(const bool & statu
 //-----------------------------------------------------------------------------
 DiagnosticReport OnTheFlyPathMatchingDiagnostic::makeReport(const core::Duration & duration)
 {
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("OnTheFlyPathMatchingDiagnostic::makeReport");
   leaderLocalisationRateDiagnostic_.heartBeatCallback(duration);
   if (!followerLocalisationRateDiagnostic_.heartBeatCallback(duration)) {
     pathMatchingStatus_.diagnostics.clear();
@@ -0,0 +1,365 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_path/PathSectionMatching2D.hpp"
+#include "romea_core_path_matching/PathAbscissaIndex.hpp"
+
+namespace
+{
+// abscissa taken from the index, whatever the origin of matched point abscissa,
+// curve n of a section is built around its way point n
+double indexedCurvilinearAbscissa(
+  const romea::core::Path2D & path,
+  const romea::core::PathAbscissaIndex & abscissaIndex,
+  const romea::core::PathMatchedPoint2D & matchedPoint)
+{
+  const size_t sectionSize = path.getSection(matchedPoint.sectionIndex).size();
+  if (sectionSize == 0) {
+    return abscissaIndex.getSectionInitialCurvilinearAbscissa(matchedPoint.sectionIndex);
+  }
+  return abscissaIndex.getCurvilinearAbscissa(
+    matchedPoint.sectionIndex, std::min(matchedPoint.curveIndex, sectionSize - 1));
+}
+
+// Seed located at the entry or at the exit of a section, the window of a tracked research
+// from it then only covers the part of the section overlapping the tracking window
+romea::core::PathMatchedPoint2D sectionEndSeed(
+  const romea::core::PathSection2D & section,
+  const size_t & sectionIndex,
+  const bool & atEntry)
+{
+  const auto & X = section.getX();
+  const auto & Y = section.getY();
+  const size_t size = X.size();
+  const size_t wayPointIndex = atEntry ? 0 : size - 1;
+  const size_t neighbourIndex = atEntry ?
+    std::min<size_t>(1, size - 1) : size - std::min<size_t>(2, size);
+
+  romea::core::PathMatchedPoint2D seed;
+  seed.pathPosture.position = Eigen::Vector2d(X[wayPointIndex], Y[wayPointIndex]);
+  seed.pathPosture.course = atEntry ?
+    std::atan2(Y[neighbourIndex] - Y[0], X[neighbourIndex] - X[0]) :
+    std::atan2(Y[size - 1] - Y[neighbourIndex], X[size - 1] - X[neighbourIndex]);
+  seed.pathPosture.curvature = 0;
+  seed.pathPosture.dotCurvature = 0;
+  seed.frenetPose.curvilinearAbscissa = 0;
+  seed.frenetPose.lateralDeviation = 0;
+  seed.frenetPose.courseDeviation = 0;
+  for (size_t n = 1; !atEntry && n < size; ++n) {
+    seed.frenetPose.curvilinearAbscissa += std::hypot(X[n] - X[n - 1], Y[n] - Y[n - 1]);
+  }
+  seed.sectionIndex = sectionIndex;
+  seed.curveIndex = wayPointIndex;
+  return seed;
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+PathAbscissaIndex::PathAbscissaIndex()
+: curvilinearAbscissas_(),
+  sectionOffsets_(1, 0),
+  sectionInitialCurvilinearAbscissas_()
+{
+}
+
+//-----------------------------------------------------------------------------
+PathAbscissaIndex::PathAbscissaIndex(const Path2D & path)
+: curvilinearAbscissas_(),
+  sectionOffsets_(1, 0),
+  sectionInitialCurvilinearAbscissas_()
+{
+  double abscissa = 0;
+  for (size_t s = 0; s < path.size(); ++s) {
+    const auto & X = path.getSection(s).getX();
+    const auto & Y = path.getSection(s).getY();
+    sectionInitialCurvilinearAbscissas_.push_back(abscissa);
+    for (size_t n = 0; n < X.size(); ++n) {
+      if (n != 0) {
+        abscissa += std::hypot(X[n] - X[n - 1], Y[n] - Y[n - 1]);
+      }
+      curvilinearAbscissas_.push_back(abscissa);
+    }
+    sectionOffsets_.push_back(curvilinearAbscissas_.size());
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathAbscissaIndex::updateSection(const size_t & sectionIndex, const PathSection2D & section)
+{
+  const auto & X = section.getX();
+  const auto & Y = section.getY();
+
+  std::vector<double> sectionAbscissas;
+  sectionAbscissas.reserve(X.size());
+  double abscissa = sectionInitialCurvilinearAbscissas_[sectionIndex];
+  for (size_t n = 0; n < X.size(); ++n) {
+    if (n != 0) {
+      abscissa += std::hypot(X[n] - X[n - 1], Y[n] - Y[n - 1]);
+    }
+    sectionAbscissas.push_back(abscissa);
+  }
+
+  const double lengthOffset = abscissa - getSectionFinalCurvilinearAbscissa(sectionIndex);
+  const size_t firstOffset = sectionOffsets_[sectionIndex];
+  const size_t lastOffset = sectionOffsets_[sectionIndex + 1];
+
+  curvilinearAbscissas_.erase(
+    curvilinearAbscissas_.begin() + firstOffset,
+    curvilinearAbscissas_.begin() + lastOffset);
+  curvilinearAbscissas_.insert(
+    curvilinearAbscissas_.begin() + firstOffset,
+    sectionAbscissas.begin(), sectionAbscissas.end());
+
+  // way points of following sections are only moved along the path
+  const size_t followingOffset = firstOffset + sectionAbscissas.size();
+  for (size_t n = followingOffset; n < curvilinearAbscissas_.size(); ++n) {
+    curvilinearAbscissas_[n] += lengthOffset;
+  }
+  for (size_t s = sectionIndex + 1; s < sectionOffsets_.size(); ++s) {
+    sectionOffsets_[s] = sectionOffsets_[s] - lastOffset + followingOffset;
+  }
+  for (size_t s = sectionIndex + 1; s < sectionInitialCurvilinearAbscissas_.size(); ++s) {
+    sectionInitialCurvilinearAbscissas_[s] += lengthOffset;
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::pair<size_t, size_t> PathAbscissaIndex::locate(const double & curvilinearAbscissa) const
+{
+  const size_t sectionIndex = findSection(curvilinearAbscissa);
+  auto first = curvilinearAbscissas_.begin() + sectionOffsets_[sectionIndex];
+  auto last = curvilinearAbscissas_.begin() + sectionOffsets_[sectionIndex + 1];
+  if (first == last) {
+    return {sectionIndex, 0};
+  }
+
+  // last way point whose abscissa is lower or equal, segment starts there
+  auto it = std::upper_bound(first, last, curvilinearAbscissa);
+  size_t wayPointIndex = it == first ? 0 : std::distance(first, it) - 1;
+  return {sectionIndex, std::min<size_t>(wayPointIndex, std::distance(first, last) - 1)};
+}
+
+//-----------------------------------------------------------------------------
+size_t PathAbscissaIndex::findSection(const double & curvilinearAbscissa) const
+{
+  if (sectionInitialCurvilinearAbscissas_.empty()) {
+    return 0;
+  }
+
+  auto it = std::upper_bound(
+    sectionInitialCurvilinearAbscissas_.begin(),
+    sectionInitialCurvilinearAbscissas_.end(),
+    curvilinearAbscissa);
+  return it == sectionInitialCurvilinearAbscissas_.begin() ? 0 :
+         std::distance(sectionInitialCurvilinearAbscissas_.begin(), it) - 1;
+}
+
+//-----------------------------------------------------------------------------
+std::pair<size_t, size_t> PathAbscissaIndex::findSections(
+  const double & minimalCurvilinearAbscissa,
+  const double & maximalCurvilinearAbscissa) const
+{
+  size_t first = findSection(minimalCurvilinearAbscissa);
+  size_t last = findSection(maximalCurvilinearAbscissa);
+
+  // zero length sections share their abscissa with the following ones
+  while (first > 0 &&
+    getSectionFinalCurvilinearAbscissa(first - 1) >= minimalCurvilinearAbscissa)
+  {
+    --first;
+  }
+  return {first, last};
+}
+
+//-----------------------------------------------------------------------------
+std::optional<size_t> PathAbscissaIndex::nextSection(const size_t & sectionIndex) const
+{
+  if (sectionIndex + 1 < size()) {
+    return sectionIndex + 1;
+  }
+  return std::nullopt;
+}
+
+//-----------------------------------------------------------------------------
+std::optional<size_t> PathAbscissaIndex::previousSection(const size_t & sectionIndex) const
+{
+  if (sectionIndex > 0 && sectionIndex <= size()) {
+    return sectionIndex - 1;
+  }
+  return std::nullopt;
+}
+
+//-----------------------------------------------------------------------------
+double PathAbscissaIndex::getSectionInitialCurvilinearAbscissa(const size_t & sectionIndex) const
+{
+  return sectionInitialCurvilinearAbscissas_[sectionIndex];
+}
+
+//-----------------------------------------------------------------------------
+double PathAbscissaIndex::getSectionFinalCurvilinearAbscissa(const size_t & sectionIndex) const
+{
+  const size_t offset = sectionOffsets_[sectionIndex + 1];
+  return offset == sectionOffsets_[sectionIndex] ?
+         sectionInitialCurvilinearAbscissas_[sectionIndex] : curvilinearAbscissas_[offset - 1];
+}
+
+//-----------------------------------------------------------------------------
+double PathAbscissaIndex::getCurvilinearAbscissa(
+  const size_t & sectionIndex,
+  const size_t & wayPointIndex) const
+{
+  return curvilinearAbscissas_[sectionOffsets_[sectionIndex] + wayPointIndex];
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<double> & PathAbscissaIndex::getCurvilinearAbscissas() const
+{
+  return curvilinearAbscissas_;
+}
+
+//-----------------------------------------------------------------------------
+size_t PathAbscissaIndex::getSectionOffset(const size_t & sectionIndex) const
+{
+  return sectionOffsets_[sectionIndex];
+}
+
+//-----------------------------------------------------------------------------
+size_t PathAbscissaIndex::size() const
+{
+  return sectionInitialCurvilinearAbscissas_.size();
+}
+
+//-----------------------------------------------------------------------------
+bool PathAbscissaIndex::empty() const
+{
+  return sectionInitialCurvilinearAbscissas_.empty();
+}
+
+//-----------------------------------------------------------------------------
+double matchedPointCurvilinearAbscissa(
+  const Path2D & path,
+  const PathAbscissaIndex & abscissaIndex,
+  const PathMatchedPoint2D & matchedPoint)
+{
+  const auto & section = path.getSection(matchedPoint.sectionIndex);
+  if (section.size() == 0) {
+    return abscissaIndex.getSectionInitialCurvilinearAbscissa(matchedPoint.sectionIndex);
+  }
+
+  const size_t wayPointIndex = std::min(matchedPoint.curveIndex, section.size() - 1);
+  const Eigen::Vector2d wayPoint(section.getX()[wayPointIndex], section.getY()[wayPointIndex]);
+  const Eigen::Vector2d tangent(
+    std::cos(matchedPoint.pathPosture.course),
+    std::sin(matchedPoint.pathPosture.course));
+
+  const double abscissa = abscissaIndex.getCurvilinearAbscissa(
+    matchedPoint.sectionIndex, wayPointIndex) +
+    tangent.dot(matchedPoint.pathPosture.position - wayPoint);
+
+  return std::clamp(
+    abscissa,
+    abscissaIndex.getSectionInitialCurvilinearAbscissa(matchedPoint.sectionIndex),
+    abscissaIndex.getSectionFinalCurvilinearAbscissa(matchedPoint.sectionIndex));
+}
+
+//-----------------------------------------------------------------------------
+std::vector<PathMatchedPoint2D> matchInTrackingWindow(
+  const Path2D & path,
+  const CoarsePathIndex & pathIndex,
+  const PathAbscissaIndex & abscissaIndex,
+  const Pose2D & vehiclePose,
+  const double & vehicleSpeed,
+  const PathMatchedPoint2D & seed,
+  const double & trackingWindowLength,
+  const double & predictionTimeHorizon,
+  const double & maximalResearchRadius)
+{
+  std::vector<PathMatchedPoint2D> matchedPoints;
+  if (seed.sectionIndex >= path.size()) {
+    return matchedPoints;
+  }
+
+  // window is stretched in the direction of motion, backward when the vehicle reverses
+  const double seedAbscissa = indexedCurvilinearAbscissa(path, abscissaIndex, seed);
+  const double predictedShift = vehicleSpeed * predictionTimeHorizon;
+  const double minimalAbscissa = seedAbscissa + std::min(predictedShift, 0.) - trackingWindowLength;
+  const double maximalAbscissa = seedAbscissa + std::max(predictedShift, 0.) + trackingWindowLength;
+
+  auto [first, last] = abscissaIndex.findSections(minimalAbscissa, maximalAbscissa);
+  first = std::min(first, seed.sectionIndex);
+  last = std::max(last, seed.sectionIndex);
+
+  for (size_t n = first; n <= last; ++n) {
+    std::optional<PathMatchedPoint2D> matchedPoint;
+    if (n == seed.sectionIndex) {
+      matchedPoint = romea::core::match(
+        path.getSection(n),
+        vehiclePose,
+        vehicleSpeed,
+        seed,
+        trackingWindowLength,
+        predictionTimeHorizon,
+        maximalResearchRadius);
+    } else if (path.getSection(n).size() != 0 &&
+      pathIndex.isCandidateSection(n, vehiclePose.position, maximalResearchRadius))
+    {
+      // neighbour sections are entered or left at one of their ends, research is seeded
+      // there and its window only covers the overlap with the tracking window
+      const bool atEntry = n > seed.sectionIndex;
+      const double windowLength = atEntry ?
+        maximalAbscissa - abscissaIndex.getSectionInitialCurvilinearAbscissa(n) :
+        abscissaIndex.getSectionFinalCurvilinearAbscissa(n) - minimalAbscissa;
+      matchedPoint = romea::core::match(
+        path.getSection(n),
+        vehiclePose,
+        vehicleSpeed,
+        sectionEndSeed(path.getSection(n), n, atEntry),
+        std::max(windowLength, 0.),
+        predictionTimeHorizon,
+        maximalResearchRadius);
+
+      if (matchedPoint.has_value()) {
+        matchedPoint->sectionIndex = n;
+        // neighbour matches outside of the window belong to another pass of the path
+        double abscissa = indexedCurvilinearAbscissa(path, abscissaIndex, *matchedPoint);
+        if (abscissa < minimalAbscissa || abscissa > maximalAbscissa) {
+          matchedPoint.reset();
+        }
+      }
+    }
+
+    if (matchedPoint.has_value()) {
+      matchedPoint->sectionIndex = n;
+      matchedPoints.push_back(*matchedPoint);
+    }
+  }
+  return matchedPoints;
+}
+
+}  // namespace core
+}  // namespace romea
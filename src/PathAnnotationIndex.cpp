@@ -0,0 +1,161 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PathAnnotationIndex.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+PathAnnotationRange::PathAnnotationRange(
+  const const_iterator & first,
+  const const_iterator & last)
+: first_(first),
+  last_(last)
+{
+}
+
+//-----------------------------------------------------------------------------
+PathAnnotationRange::const_iterator PathAnnotationRange::begin() const
+{
+  return first_;
+}
+
+//-----------------------------------------------------------------------------
+PathAnnotationRange::const_iterator PathAnnotationRange::end() const
+{
+  return last_;
+}
+
+//-----------------------------------------------------------------------------
+size_t PathAnnotationRange::size() const
+{
+  return std::distance(first_, last_);
+}
+
+//-----------------------------------------------------------------------------
+bool PathAnnotationRange::empty() const
+{
+  return first_ == last_;
+}
+
+//-----------------------------------------------------------------------------
+PathAnnotationIndex::PathAnnotationIndex()
+: annotations_()
+{
+}
+
+//-----------------------------------------------------------------------------
+PathAnnotationIndex::PathAnnotationIndex(
+  const Path2D & path,
+  const PathAbscissaIndex & abscissaIndex)
+: annotations_()
+{
+  const auto & curvilinearAbscissas = abscissaIndex.getCurvilinearAbscissas();
+  for (const auto & annotation : path.getAnnotations()) {
+    // annotations of way points removed since loading are dropped
+    if (annotation.pointIndex < curvilinearAbscissas.size()) {
+      annotations_.push_back({curvilinearAbscissas[annotation.pointIndex], annotation});
+    }
+  }
+
+  // file order is kept between annotations of a same way point
+  std::stable_sort(
+    annotations_.begin(), annotations_.end(),
+    [](const IndexedPathAnnotation & lhs, const IndexedPathAnnotation & rhs) {
+      return lhs.curvilinearAbscissa < rhs.curvilinearAbscissa;
+    });
+}
+
+//-----------------------------------------------------------------------------
+void PathAnnotationIndex::update(
+  const PathAbscissaIndex & abscissaIndex,
+  const size_t & firstPointIndex)
+{
+  const auto & curvilinearAbscissas = abscissaIndex.getCurvilinearAbscissas();
+  annotations_.erase(
+    std::remove_if(
+      annotations_.begin(), annotations_.end(),
+      [&curvilinearAbscissas](const IndexedPathAnnotation & indexedAnnotation) {
+        return indexedAnnotation.annotation.pointIndex >= curvilinearAbscissas.size();
+      }),
+    annotations_.end());
+
+  for (auto & indexedAnnotation : annotations_) {
+    if (indexedAnnotation.annotation.pointIndex >= firstPointIndex) {
+      indexedAnnotation.curvilinearAbscissa =
+        curvilinearAbscissas[indexedAnnotation.annotation.pointIndex];
+    }
+  }
+
+  // annotations are few, sorting them again is cheap whatever the path size
+  std::stable_sort(
+    annotations_.begin(), annotations_.end(),
+    [](const IndexedPathAnnotation & lhs, const IndexedPathAnnotation & rhs) {
+      return lhs.curvilinearAbscissa < rhs.curvilinearAbscissa;
+    });
+}
+
+//-----------------------------------------------------------------------------
+PathAnnotationRange PathAnnotationIndex::find(
+  const double & curvilinearAbscissa,
+  const double & distance) const
+{
+  const double minimalCurvilinearAbscissa = curvilinearAbscissa + std::min(distance, 0.);
+  const double maximalCurvilinearAbscissa = curvilinearAbscissa + std::max(distance, 0.);
+
+  auto first = std::lower_bound(
+    annotations_.begin(), annotations_.end(), minimalCurvilinearAbscissa,
+    [](const IndexedPathAnnotation & annotation, const double & abscissa) {
+      return annotation.curvilinearAbscissa < abscissa;
+    });
+
+  auto last = std::upper_bound(
+    first, annotations_.end(), maximalCurvilinearAbscissa,
+    [](const double & abscissa, const IndexedPathAnnotation & annotation) {
+      return abscissa < annotation.curvilinearAbscissa;
+    });
+
+  return PathAnnotationRange(first, last);
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<IndexedPathAnnotation> & PathAnnotationIndex::getAnnotations() const
+{
+  return annotations_;
+}
+
+//-----------------------------------------------------------------------------
+size_t PathAnnotationIndex::size() const
+{
+  return annotations_.size();
+}
+
+//-----------------------------------------------------------------------------
+bool PathAnnotationIndex::empty() const
+{
+  return annotations_.empty();
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,308 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// posix
+#include <unistd.h>
+
+// romea
+#include "romea_core_path_matching/PathCache.hpp"
+
+namespace
+{
+const uint32_t MAGIC = 0x434d5052;  // "RPMC"
+const uint32_t VERSION = 2;
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t fnv1a(const void * data, const size_t & size, uint64_t hash = FNV_OFFSET_BASIS)
+{
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+  for (size_t n = 0; n < size; ++n) {
+    hash = (hash ^ bytes[n]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+template<typename T>
+void write(std::string & buffer, const T & value)
+{
+  buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read(const char * data, const size_t & size, size_t & offset, T & value)
+{
+  if (offset + sizeof(T) > size) {
+    return false;
+  }
+  std::memcpy(&value, data + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+void write(std::string & buffer, const std::string & value)
+{
+  write(buffer, static_cast<uint64_t>(value.size()));
+  buffer.append(value);
+}
+
+bool read(const char * data, const size_t & size, size_t & offset, std::string & value)
+{
+  uint64_t length;
+  if (!read(data, size, offset, length) || length > size - offset) {
+    return false;
+  }
+  value.assign(data + offset, length);
+  offset += length;
+  return true;
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+uint64_t PathCacheKey::hash() const
+{
+  uint64_t hash = fnv1a(&fileHash, sizeof(fileHash));
+  hash = fnv1a(&wgs84Anchor.latitude, sizeof(double), hash);
+  hash = fnv1a(&wgs84Anchor.longitude, sizeof(double), hash);
+  hash = fnv1a(&wgs84Anchor.altitude, sizeof(double), hash);
+  hash = fnv1a(&interpolationWindowLength, sizeof(double), hash);
+  return fnv1a(&maximalConversionError, sizeof(double), hash);
+}
+
+//-----------------------------------------------------------------------------
+uint64_t hashFile(const std::string & filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file " + filename);
+  }
+
+  uint64_t hash = FNV_OFFSET_BASIS;
+  std::vector<char> chunk(1 << 16);
+  while (file) {
+    file.read(chunk.data(), chunk.size());
+    hash = fnv1a(chunk.data(), static_cast<size_t>(file.gcount()), hash);
+  }
+  return hash;
+}
+
+//-----------------------------------------------------------------------------
+PathCacheKey makePathCacheKey(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & interpolationWindowLength,
+  const double & maximalConversionError)
+{
+  return {hashFile(pathFilename), wgs84Anchor, interpolationWindowLength, maximalConversionError};
+}
+
+//-----------------------------------------------------------------------------
+void serialize(const PathCacheKey & key, const CachedPath & path, std::string & buffer)
+{
+  buffer.clear();
+  write(buffer, MAGIC);
+  write(buffer, VERSION);
+  write(buffer, key.fileHash);
+  write(buffer, key.wgs84Anchor.latitude);
+  write(buffer, key.wgs84Anchor.longitude);
+  write(buffer, key.wgs84Anchor.altitude);
+  write(buffer, key.interpolationWindowLength);
+  write(buffer, key.maximalConversionError);
+
+  write(buffer, static_cast<uint64_t>(path.wayPoints.size()));
+  for (const auto & sectionWayPoints : path.wayPoints) {
+    write(buffer, static_cast<uint64_t>(sectionWayPoints.size()));
+    for (const auto & wayPoint : sectionWayPoints) {
+      write(buffer, wayPoint.position.x());
+      write(buffer, wayPoint.position.y());
+      write(buffer, wayPoint.desiredSpeed);
+    }
+  }
+
+  write(buffer, static_cast<uint64_t>(path.annotations.size()));
+  for (const auto & annotation : path.annotations) {
+    write(buffer, annotation.type);
+    write(buffer, annotation.value);
+    write(buffer, static_cast<uint64_t>(annotation.pointIndex));
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::optional<CachedPath> deserialize(
+  const PathCacheKey & key,
+  const char * data,
+  const size_t & size)
+{
+  size_t offset = 0;
+  uint32_t magic, version;
+  PathCacheKey storedKey;
+  if (!read(data, size, offset, magic) || magic != MAGIC ||
+    !read(data, size, offset, version) || version != VERSION ||
+    !read(data, size, offset, storedKey.fileHash) ||
+    !read(data, size, offset, storedKey.wgs84Anchor.latitude) ||
+    !read(data, size, offset, storedKey.wgs84Anchor.longitude) ||
+    !read(data, size, offset, storedKey.wgs84Anchor.altitude) ||
+    !read(data, size, offset, storedKey.interpolationWindowLength) ||
+    !read(data, size, offset, storedKey.maximalConversionError))
+  {
+    return std::nullopt;
+  }
+
+  if (storedKey.fileHash != key.fileHash ||
+    storedKey.wgs84Anchor.latitude != key.wgs84Anchor.latitude ||
+    storedKey.wgs84Anchor.longitude != key.wgs84Anchor.longitude ||
+    storedKey.wgs84Anchor.altitude != key.wgs84Anchor.altitude ||
+    storedKey.interpolationWindowLength != key.interpolationWindowLength ||
+    storedKey.maximalConversionError != key.maximalConversionError)
+  {
+    return std::nullopt;
+  }
+
+  uint64_t numberOfSections;
+  if (!read(data, size, offset, numberOfSections)) {
+    return std::nullopt;
+  }
+
+  CachedPath path;
+  for (uint64_t s = 0; s < numberOfSections; ++s) {
+    uint64_t numberOfWayPoints;
+    if (!read(data, size, offset, numberOfWayPoints) ||
+      numberOfWayPoints > (size - offset) / (3 * sizeof(double)))
+    {
+      return std::nullopt;
+    }
+
+    auto & sectionWayPoints = path.wayPoints.emplace_back();
+    sectionWayPoints.reserve(numberOfWayPoints);
+    for (uint64_t n = 0; n < numberOfWayPoints; ++n) {
+      double x, y, desiredSpeed;
+      read(data, size, offset, x);
+      read(data, size, offset, y);
+      read(data, size, offset, desiredSpeed);
+      sectionWayPoints.emplace_back(Eigen::Vector2d(x, y), desiredSpeed);
+    }
+  }
+
+  uint64_t numberOfAnnotations;
+  if (!read(data, size, offset, numberOfAnnotations)) {
+    return std::nullopt;
+  }
+
+  for (uint64_t n = 0; n < numberOfAnnotations; ++n) {
+    std::string type, value;
+    uint64_t pointIndex;
+    if (!read(data, size, offset, type) ||
+      !read(data, size, offset, value) ||
+      !read(data, size, offset, pointIndex))
+    {
+      return std::nullopt;
+    }
+    path.annotations.push_back({type, value, static_cast<size_t>(pointIndex)});
+  }
+
+  if (offset != size) {
+    return std::nullopt;
+  }
+  return path;
+}
+
+//-----------------------------------------------------------------------------
+PathCache::PathCache(const std::string & directory)
+: directory_(directory)
+{
+  // an unusable cache directory must not prevent loading paths
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  if (error || !std::filesystem::is_directory(directory_, error)) {
+    directory_.clear();
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool PathCache::isEnabled() const
+{
+  return !directory_.empty();
+}
+
+//-----------------------------------------------------------------------------
+std::string PathCache::getEntryFilename(const PathCacheKey & key) const
+{
+  std::ostringstream filename;
+  filename << directory_ << "/" << std::hex << key.hash() << ".path_cache";
+  return filename.str();
+}
+
+//-----------------------------------------------------------------------------
+std::optional<CachedPath> PathCache::load(const PathCacheKey & key) const
+{
+  if (!isEnabled()) {
+    return std::nullopt;
+  }
+
+  std::ifstream file(getEntryFilename(key), std::ios::binary);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+
+  std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return deserialize(key, buffer.data(), buffer.size());
+}
+
+//-----------------------------------------------------------------------------
+void PathCache::store(const PathCacheKey & key, const CachedPath & path) const
+{
+  if (!isEnabled()) {
+    return;
+  }
+
+  std::string buffer;
+  serialize(key, path, buffer);
+
+  // written aside then renamed so concurrent readers never see a partial entry
+  std::string filename = getEntryFilename(key);
+  std::string temporaryFilename = filename + ".tmp." + std::to_string(::getpid());
+  {
+    std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), buffer.size());
+    if (!file) {
+      std::remove(temporaryFilename.c_str());
+      return;
+    }
+  }
+  if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(temporaryFilename.c_str());
+  }
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,194 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/geodesy/ENUConverter.hpp"
+#include "romea_core_path/PathFile.hpp"
+#include "romea_core_path_matching/LocalTangentPlaneConverter.hpp"
+#include "romea_core_path_matching/PathCache.hpp"
+#include "romea_core_path_matching/PathLoader.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
+
+namespace
+{
+romea::core::PathWayPoints2D load_way_points(
+  const romea::core::PathFile & pathFile,
+  const romea::core::GeodeticCoordinates & wgs84Anchor)
+{
+  romea::core::ENUConverter enuConverter(wgs84Anchor);
+  Eigen::Vector2d offset = enuConverter.toENU(*pathFile.getWGS84Anchor()).head<2>();
+  std::cout << " offset path matching " << offset.transpose() << std::endl;
+
+  romea::core::PathWayPoints2D pathWayPoints = pathFile.getWayPoints();
+  for (auto & sectionWayPoints : pathWayPoints) {
+    for (auto & wayPoints : sectionWayPoints) {
+      wayPoints.position -= offset;
+    }
+  }
+  return pathWayPoints;
+}
+
+romea::core::Path2D create_path(
+  const std::string & pathFilename,
+  const romea::core::GeodeticCoordinates & wgs84Anchor,
+  const double & interpolationWindowLength,
+  const double & maximalConversionError)
+{
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("create_path");
+  if (romea::core::isWGS84PathFile(pathFilename)) {
+    return romea::core::Path2D(
+      romea::core::loadWGS84WayPoints(pathFilename, wgs84Anchor, maximalConversionError),
+      interpolationWindowLength);
+  }
+
+  romea::core::PathFile pathFile(pathFilename);
+
+  return romea::core::Path2D(
+    load_way_points(pathFile, wgs84Anchor),
+    interpolationWindowLength,
+    pathFile.getAnnotations());
+}
+
+romea::core::Path2D create_path(
+  const std::string & pathFilename,
+  const romea::core::GeodeticCoordinates & wgs84Anchor,
+  const double & interpolationWindowLength,
+  const double & maximalConversionError,
+  const romea::core::PathCache & pathCache)
+{
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("create_path with cache");
+  auto key = romea::core::makePathCacheKey(
+    pathFilename, wgs84Anchor, interpolationWindowLength, maximalConversionError);
+
+  // only parsing and conversion are saved, curves are interpolated on each load
+  std::optional<romea::core::CachedPath> cachedPath = pathCache.load(key);
+  if (!cachedPath.has_value()) {
+    cachedPath.emplace();
+    if (romea::core::isWGS84PathFile(pathFilename)) {
+      cachedPath->wayPoints = romea::core::loadWGS84WayPoints(
+        pathFilename, wgs84Anchor, maximalConversionError);
+    } else {
+      romea::core::PathFile pathFile(pathFilename);
+      cachedPath->wayPoints = load_way_points(pathFile, wgs84Anchor);
+      cachedPath->annotations = pathFile.getAnnotations();
+    }
+    pathCache.store(key, *cachedPath);
+  }
+
+  return romea::core::Path2D(
+    cachedPath->wayPoints,
+    interpolationWindowLength,
+    cachedPath->annotations);
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+Path2D loadPath(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & interpolationWindowLength,
+  const std::string & pathCacheDirectory,
+  const double & maximalConversionError)
+{
+  if (pathCacheDirectory.empty()) {
+    return create_path(
+      pathFilename, wgs84Anchor, interpolationWindowLength, maximalConversionError);
+  } else {
+    return create_path(
+      pathFilename, wgs84Anchor, interpolationWindowLength, maximalConversionError,
+      PathCache(pathCacheDirectory));
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool isWGS84PathFile(const std::string & pathFilename)
+{
+  std::ifstream file(pathFilename);
+  std::string header;
+  return file >> header && header == "WGS84_WAYPOINTS";
+}
+
+//-----------------------------------------------------------------------------
+PathWayPoints2D loadWGS84WayPoints(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const double & maximalConversionError)
+{
+  std::ifstream file(pathFilename);
+  std::string line;
+  if (!std::getline(file, line) || line.rfind("WGS84_WAYPOINTS", 0) != 0) {
+    throw std::runtime_error("Unable to read WGS84 path file " + pathFilename);
+  }
+
+  // all sections are converted in a single batch
+  std::vector<double> latitudes;
+  std::vector<double> longitudes;
+  std::vector<double> speeds;
+  std::vector<size_t> sectionSizes(1, 0);
+  while (std::getline(file, line)) {
+    std::istringstream stream(line);
+    double latitude, longitude, speed;
+    if (!(stream >> latitude)) {
+      if (sectionSizes.back() != 0) {
+        sectionSizes.push_back(0);
+      }
+      continue;
+    }
+    if (!(stream >> longitude >> speed)) {
+      throw std::runtime_error("Invalid way point in WGS84 path file " + pathFilename);
+    }
+    latitudes.push_back(latitude * M_PI / 180.);
+    longitudes.push_back(longitude * M_PI / 180.);
+    speeds.push_back(speed);
+    ++sectionSizes.back();
+  }
+  if (sectionSizes.back() == 0) {
+    sectionSizes.pop_back();
+  }
+
+  std::vector<double> east;
+  std::vector<double> north;
+  LocalTangentPlaneConverter converter(wgs84Anchor, maximalConversionError);
+  converter.toENU(latitudes, longitudes, east, north);
+
+  PathWayPoints2D wayPoints;
+  size_t n = 0;
+  for (const size_t & sectionSize : sectionSizes) {
+    auto & sectionWayPoints = wayPoints.emplace_back();
+    sectionWayPoints.reserve(sectionSize);
+    for (size_t i = 0; i < sectionSize; ++i, ++n) {
+      sectionWayPoints.emplace_back(Eigen::Vector2d(east[n], north[n]), speeds[n]);
+    }
+  }
+  return wayPoints;
+}
+
+}  // namespace core
+}  // namespace romea
@@ -13,40 +13,54 @@
 // limitations under the License.
 
 // std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <variant>
 #include <vector>
 
 // romea
-#include "romea_core_common/geodesy/ENUConverter.hpp"
-#include "romea_core_path/PathFile.hpp"
-#include "romea_core_path/PathMatching2D.hpp"
+#include "romea_core_path_matching/PathLoader.hpp"
 #include "romea_core_path_matching/PathMatching.hpp"
+#include "romea_core_path_matching/PathMatchingT.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
 
 namespace
 {
-romea::core::Path2D create_path(
-  const std::string & pathFilename,
-  const romea::core::GeodeticCoordinates & wgs84Anchor,
-  const double & interpolationWindowLength)
-{
-  romea::core::PathFile pathFile(pathFilename);
-  romea::core::ENUConverter enuConverter(wgs84Anchor);
-  Eigen::Vector2d offset = enuConverter.toENU(*pathFile.getWGS84Anchor()).head<2>();
-  std::cout << " offset path matching " << offset.transpose() << std::endl;
-
-  std::vector<std::vector<romea::core::PathWayPoint2D>> pathWayPoints = pathFile.getWayPoints();
-  for (auto & sectionWayPoints : pathWayPoints) {
-    for (auto & wayPoints : sectionWayPoints) {
-      wayPoints.position -= offset;
-    }
+void appendWayPoints(
+  const romea::core::PathSection2D & section,
+  const size_t & firstIndex,
+  const size_t & lastIndex,
+  std::vector<romea::core::PathWayPoint2D> & wayPoints)
+{
+  const auto & X = section.getX();
+  const auto & Y = section.getY();
+  const auto & speeds = section.getSpeeds();
+  for (size_t n = firstIndex; n < lastIndex; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(X[n], Y[n]), speeds[n]);
   }
+}
 
-  return romea::core::Path2D(
-    pathWayPoints,
-    interpolationWindowLength,
-    pathFile.getAnnotations());
+// -1 when the desired speed of the path at the matched point is negative, on a section
+// driven in reverse
+double desiredSpeedSign(
+  const romea::core::Path2D & path,
+  const romea::core::PathMatchedPoint2D & matchedPoint)
+{
+  const auto & speeds = path.getSection(matchedPoint.sectionIndex).getSpeeds();
+  if (speeds.empty()) {
+    return 1;
+  }
+  return speeds[std::min(matchedPoint.curveIndex, speeds.size() - 1)] < 0 ? -1 : 1;
 }
+
 }  // namespace
 
 namespace romea
@@ -59,13 +73,71 @@ PathMatching::PathMatching(
   const std::string & pathFilename,
   const GeodeticCoordinates & wgs84Anchor,
   const double & maximalResearchRadius,
-  const double & interpolationWindowLength)
+  const double & interpolationWindowLength,
+  const std::string & pathCacheDirectory,
+  const DiagnosticsMode & diagnosticsMode)
 : maximalResearchRadius_(maximalResearchRadius),
-  path_(create_path(pathFilename, wgs84Anchor, interpolationWindowLength)),
+  interpolationWindowLength_(interpolationWindowLength),
+  path_(loadPath(pathFilename, wgs84Anchor, interpolationWindowLength, pathCacheDirectory)),
+  pathIndex_(path_),
+  abscissaIndex_(path_),
+  annotationIndex_(path_, abscissaIndex_),
+  postureTable_(),
   matchedPoints_(),
+  matchedPointsAnnotations_(),
+  annotationLookaheadDistance_(0),
   // trackedMatchedPointIndex_(0),
-  diagnostics_(pathFilename)
+  preparedPathSlot_(std::make_shared<PreparedPathSlot>()),
+  numberOfGlobalResearches_(0),
+  postureTableSamplingStep_(),
+  compactPostureTable_(false),
+  changeDetector_(),
+  numberOfSkippedResearches_(0),
+  diagnostics_(makeDiagnostics_(pathFilename, diagnosticsMode))
+{
+}
+
+//-----------------------------------------------------------------------------
+PathMatching::~PathMatching()
+{
+  supersedePreparedPath_();
+  joinLoaderThreads_(false);
+}
+
+//-----------------------------------------------------------------------------
+PathMatching::Diagnostics PathMatching::makeDiagnostics_(
+  const std::string & pathFilename,
+  const DiagnosticsMode & diagnosticsMode)
+{
+  switch (diagnosticsMode) {
+    case DiagnosticsMode::DEFERRED:
+      return Diagnostics(std::in_place_type<DeferredPathMatchingDiagnostic>, pathFilename);
+    case DiagnosticsMode::DISABLED:
+      return Diagnostics(std::in_place_type<NoDiagnostics>);
+    default:
+      return Diagnostics(std::in_place_type<PathMatchingDiagnostic>, pathFilename);
+  }
+}
+
+//-----------------------------------------------------------------------------
+PathMatching::PreparedPath::PreparedPath(
+  Path2D && path,
+  const double & interpolationWindowLength,
+  const std::optional<double> & postureTableSamplingStep,
+  const bool & compactPostureTable)
+: path(std::move(path)),
+  pathIndex(this->path),
+  abscissaIndex(this->path),
+  annotationIndex(this->path, abscissaIndex),
+  postureTable()
 {
+  if (postureTableSamplingStep.has_value()) {
+    postureTable = PathPostureTable(
+      this->path, *postureTableSamplingStep, interpolationWindowLength);
+    if (compactPostureTable) {
+      postureTable.compact();
+    }
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -74,13 +146,247 @@ const Path2D & PathMatching::getPath() const
   return path_;
 }
 
+//-----------------------------------------------------------------------------
+void PathMatching::enablePostureTable(const double & samplingStep)
+{
+  if (samplingStep <= 0) {
+    throw std::invalid_argument("Posture table sampling step must be positive");
+  }
+  postureTableSamplingStep_ = samplingStep;
+  preparePostureTable_(postureTable_, path_);
+}
+
+//-----------------------------------------------------------------------------
+const PathPostureTable & PathMatching::getPostureTable() const
+{
+  if (!postureTableSamplingStep_.has_value()) {
+    throw std::runtime_error("Posture table is not enabled");
+  }
+  return postureTable_;
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::enableCompactPostureTable()
+{
+  compactPostureTable_ = true;
+  preparePostureTable_(postureTable_, path_);
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::preparePostureTable_(
+  PathPostureTable & postureTable,
+  const Path2D & path) const
+{
+  // tables prepared by loading threads may predate the last enable calls
+  if (!postureTableSamplingStep_.has_value()) {
+    postureTable = PathPostureTable();
+    return;
+  }
+  if (postureTable.getSamplingStep() != *postureTableSamplingStep_) {
+    postureTable = PathPostureTable(path, *postureTableSamplingStep_, interpolationWindowLength_);
+  }
+  if (compactPostureTable_) {
+    postureTable.compact();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::project(
+  const std::vector<Eigen::Vector2d> & points,
+  PathFrenetCoordinates2D & coordinates) const
+{
+  PathProjector(path_, pathIndex_, abscissaIndex_).project(
+    points, maximalResearchRadius_, coordinates);
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::project(
+  const std::vector<Eigen::Vector2d> & points,
+  PathFrenetCoordinates2D & coordinates,
+  const PathProjector::Executor & executor,
+  const size_t & numberOfTasks) const
+{
+  PathProjector(path_, pathIndex_, abscissaIndex_).project(
+    points, maximalResearchRadius_, coordinates, executor, numberOfTasks);
+}
+
 //-----------------------------------------------------------------------------
 void PathMatching::setPath(Path2D && path)
 {
-  path_ = std::move(path);
+  supersedePreparedPath_();
+  setPath_(PreparedPath(
+      std::move(path), interpolationWindowLength_, postureTableSamplingStep_,
+      compactPostureTable_));
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::setPath_(PreparedPath && preparedPath)
+{
+  // prepared before any move, so that nothing is swapped if it throws
+  preparePostureTable_(preparedPath.postureTable, preparedPath.path);
+
+  path_ = std::move(preparedPath.path);
+  pathIndex_ = std::move(preparedPath.pathIndex);
+  abscissaIndex_ = std::move(preparedPath.abscissaIndex);
+  annotationIndex_ = std::move(preparedPath.annotationIndex);
+  postureTable_ = std::move(preparedPath.postureTable);
   reset();
 }
 
+//-----------------------------------------------------------------------------
+std::shared_future<void> PathMatching::loadPathAsync(
+  const std::string & pathFilename,
+  const GeodeticCoordinates & wgs84Anchor,
+  const std::string & pathCacheDirectory)
+{
+  joinLoaderThreads_(true);
+
+  std::promise<void> promise;
+  std::shared_future<void> future = promise.get_future().share();
+  const uint64_t generation = ++preparedPathSlot_->generation;
+
+  std::thread thread(
+    [slot = preparedPathSlot_, promise = std::move(promise), generation, pathFilename,
+    wgs84Anchor, interpolationWindowLength = interpolationWindowLength_, pathCacheDirectory,
+    postureTableSamplingStep = postureTableSamplingStep_,
+    compactPostureTable = compactPostureTable_]() mutable {
+      try {
+        auto preparedPath = std::make_shared<PreparedPath>(
+          loadPath(pathFilename, wgs84Anchor, interpolationWindowLength, pathCacheDirectory),
+          interpolationWindowLength,
+          postureTableSamplingStep,
+          compactPostureTable);
+        preparedPath->generation = generation;
+        preparedPath->pathFilename = pathFilename;
+
+        // match checks the generation again in case the path changes meanwhile
+        if (slot->generation.load() != generation) {
+          throw std::runtime_error("Loading of path " + pathFilename + " has been superseded");
+        }
+        std::atomic_store(&slot->preparedPath, std::move(preparedPath));
+        promise.set_value();
+      } catch (...) {
+        promise.set_exception(std::current_exception());
+      }
+    });
+
+  loaderThreads_.emplace_back(std::move(thread), future);
+  return future;
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::supersedePreparedPath_()
+{
+  ++preparedPathSlot_->generation;
+  std::atomic_store(&preparedPathSlot_->preparedPath, std::shared_ptr<PreparedPath>());
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::joinLoaderThreads_(const bool & finishedOnly)
+{
+  // a thread whose future is ready has nothing left to do but returning
+  auto it = loaderThreads_.begin();
+  while (it != loaderThreads_.end()) {
+    if (!finishedOnly ||
+      it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+      it->first.join();
+      it = loaderThreads_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::splicePath(
+  const size_t & sectionIndex,
+  const size_t & firstWayPointIndex,
+  const size_t & lastWayPointIndex,
+  const std::vector<PathWayPoint2D> & wayPoints)
+{
+  if (sectionIndex >= path_.size() ||
+    firstWayPointIndex > lastWayPointIndex ||
+    lastWayPointIndex > path_.getSection(sectionIndex).size())
+  {
+    throw std::out_of_range("Path splice range is out of path section");
+  }
+
+  // a path loaded before the splice would discard it
+  supersedePreparedPath_();
+
+  // path geometry is unchanged before the first replaced way point
+  const double spliceAbscissa = firstWayPointIndex < path_.getSection(sectionIndex).size() ?
+    abscissaIndex_.getCurvilinearAbscissa(sectionIndex, firstWayPointIndex) :
+    abscissaIndex_.getSectionFinalCurvilinearAbscissa(sectionIndex);
+  const double previousSectionLength =
+    abscissaIndex_.getSectionFinalCurvilinearAbscissa(sectionIndex) -
+    abscissaIndex_.getSectionInitialCurvilinearAbscissa(sectionIndex);
+
+  PathWayPoints2D pathWayPoints(path_.size());
+  for (size_t s = 0; s < path_.size(); ++s) {
+    const auto & section = path_.getSection(s);
+    if (s != sectionIndex) {
+      appendWayPoints(section, 0, section.size(), pathWayPoints[s]);
+    } else {
+      appendWayPoints(section, 0, firstWayPointIndex, pathWayPoints[s]);
+      pathWayPoints[s].insert(pathWayPoints[s].end(), wayPoints.begin(), wayPoints.end());
+      appendWayPoints(section, lastWayPointIndex, section.size(), pathWayPoints[s]);
+    }
+  }
+
+  // Path2D cannot replace one of its sections, it is the only structure built again,
+  // indexes only process the spliced section and shift the following ones
+  path_ = Path2D(pathWayPoints, interpolationWindowLength_, path_.getAnnotations());
+  const PathSection2D & splicedSection = path_.getSection(sectionIndex);
+  pathIndex_.updateSection(sectionIndex, splicedSection);
+  abscissaIndex_.updateSection(sectionIndex, splicedSection);
+  annotationIndex_.update(
+    abscissaIndex_, abscissaIndex_.getSectionOffset(sectionIndex) + firstWayPointIndex);
+
+  const double lengthOffset =
+    abscissaIndex_.getSectionFinalCurvilinearAbscissa(sectionIndex) -
+    abscissaIndex_.getSectionInitialCurvilinearAbscissa(sectionIndex) - previousSectionLength;
+  if (postureTableSamplingStep_.has_value()) {
+    postureTable_.update(path_, sectionIndex, spliceAbscissa, lengthOffset);
+  }
+
+  // interpolation of points located in a window before the splice has changed
+  const double unchangedAbscissa = spliceAbscissa - interpolationWindowLength_;
+
+  std::vector<PathMatchedPoint2D> remappedPoints;
+  for (PathMatchedPoint2D matchedPoint : matchedPoints_) {
+    if (matchedPoint.sectionIndex > sectionIndex) {
+      matchedPoint.frenetPose.curvilinearAbscissa += lengthOffset;
+      remappedPoints.push_back(matchedPoint);
+    } else if (matchedPoint.sectionIndex < sectionIndex) {
+      remappedPoints.push_back(matchedPoint);
+    } else if (matchedPoint.curveIndex < firstWayPointIndex &&
+      abscissaIndex_.getCurvilinearAbscissa(sectionIndex, matchedPoint.curveIndex) <
+      unchangedAbscissa)
+    {
+      remappedPoints.push_back(matchedPoint);
+    } else {
+      Pose2D pose;
+      pose.position = matchedPoint.pathPosture.position;
+      pose.yaw = matchedPoint.pathPosture.course;
+
+      std::optional<PathMatchedPoint2D> remappedPoint;
+      matchOnPathSection<NoTracking>(
+        splicedSection, pose, 0.0, 0.0, maximalResearchRadius_, remappedPoint);
+      if (remappedPoint.has_value()) {
+        remappedPoint->sectionIndex = sectionIndex;
+        remappedPoints.push_back(*remappedPoint);
+      }
+    }
+  }
+  matchedPoints_ = std::move(remappedPoints);
+
+  // ranges refer to the previous annotation index
+  matchedPointsAnnotations_.clear();
+  changeDetector_.reset();
+}
+
 //-----------------------------------------------------------------------------
 std::vector<PathMatchedPoint2D> PathMatching::match(
   const Duration & stamp,
@@ -88,48 +394,132 @@ std::vector<PathMatchedPoint2D> PathMatching::match(
   const Twist2D & vehicleTwist,
   const double & predictionTimeHorizon)
 {
-  diagnostics_.updateLocalisationRate(stamp);
-  double vehicleSpeed = vehicleTwist.linearSpeeds.x();
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("PathMatching::match");
+  std::visit(
+    [&stamp](auto & diagnostics) {diagnostics.updateLocalisationRate(stamp);}, diagnostics_);
 
-  if (matchedPoints_.empty()) {
-    matchedPoints_ = romea::core::match(
-      path_,
-      vehiclePose,
-      vehicleSpeed,
-      predictionTimeHorizon,
-      maximalResearchRadius_);
+  if (auto preparedPath = std::atomic_exchange(
+      &preparedPathSlot_->preparedPath, std::shared_ptr<PreparedPath>()))
+  {
+    if (preparedPath->generation == preparedPathSlot_->generation.load()) {
+      const std::string pathFilename = preparedPath->pathFilename;
+      setPath_(std::move(*preparedPath));
+      std::visit(
+        [&pathFilename](auto & diagnostics) {diagnostics.setPathFilename(pathFilename);},
+        diagnostics_);
+    }
+  }
+
+  // research is skipped only if all matched points stay on their curve
+  bool isExtrapolated = !matchedPoints_.empty() &&
+    !changeDetector_.hasChanged(vehiclePose, vehicleTwist, predictionTimeHorizon);
+  for (size_t n = 0; isExtrapolated && n < matchedPoints_.size(); ++n) {
+    const auto & matchedPoint = matchedPoints_[n];
+    const auto extrapolatedPoint = extrapolateMatchedPoint(
+      path_.getSection(matchedPoint.sectionIndex), matchedPoint, vehiclePose);
+    if (extrapolatedPoint.has_value()) {
+      matchedPoints_[n] = *extrapolatedPoint;
+    } else {
+      isExtrapolated = false;
+    }
+  }
+
+  if (isExtrapolated) {
+    ++numberOfSkippedResearches_;
   } else {
-    matchedPoints_ = romea::core::match(
+    numberOfGlobalResearches_ += matchOnPath<Tracking<2>>(
       path_,
+      pathIndex_,
+      abscissaIndex_,
       vehiclePose,
-      vehicleSpeed,
-      // matchedPoints_[trackedMatchedPointIndex_], 2,
-      matchedPoints_[0], 2,
+      vehicleTwist.linearSpeeds.x(),
       predictionTimeHorizon,
-      maximalResearchRadius_);
+      maximalResearchRadius_,
+      matchedPoints_);
+
+    // next pose is researched again until a match is found
+    if (matchedPoints_.empty()) {
+      reset();
+    } else {
+      changeDetector_.setReference(vehiclePose, vehicleTwist, predictionTimeHorizon);
+    }
   }
 
-  if (!matchedPoints_.empty()) {
-    diagnostics_.updatePathMatchingStatus(true);
-    // trackedMatchedPointIndex_ = bestMatchedPointIndex(matchedPoints_, vehicleSpeed);
-    // return matchedPoints_[trackedMatchedPointIndex_];
-    return matchedPoints_;
-  } else {
-    diagnostics_.updatePathMatchingStatus(false);
-    return {};
+  // capacity is kept between calls, lookahead does not allocate once warmed up
+  matchedPointsAnnotations_.clear();
+  if (annotationLookaheadDistance_ > 0) {
+    // the vehicle moves toward increasing abscissas when it drives forward on a forward
+    // section or backward on a reverse one
+    const double distance = vehicleTwist.linearSpeeds.x() < 0 ?
+      -annotationLookaheadDistance_ : annotationLookaheadDistance_;
+    for (const auto & matchedPoint : matchedPoints_) {
+      matchedPointsAnnotations_.push_back(
+        nextAnnotations(matchedPoint, distance * desiredSpeedSign(path_, matchedPoint)));
+    }
+  }
+
+  std::visit(
+    [status = !matchedPoints_.empty()](auto & diagnostics) {
+      diagnostics.updatePathMatchingStatus(status);
+    }, diagnostics_);
+  return matchedPoints_;
+}
+
+//-----------------------------------------------------------------------------
+PathAnnotationRange PathMatching::nextAnnotations(
+  const PathMatchedPoint2D & matchedPoint,
+  const double & distance) const
+{
+  return annotationIndex_.find(
+    matchedPointCurvilinearAbscissa(path_, abscissaIndex_, matchedPoint), distance);
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::setAnnotationLookaheadDistance(const double & distance)
+{
+  if (distance < 0) {
+    throw std::invalid_argument("Annotation lookahead distance must be positive");
   }
+  annotationLookaheadDistance_ = distance;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<PathAnnotationRange> & PathMatching::getMatchedPointsAnnotations() const
+{
+  return matchedPointsAnnotations_;
+}
+
+//-----------------------------------------------------------------------------
+void PathMatching::enableChangeDetection(const PoseChangeThresholds & thresholds)
+{
+  changeDetector_ = PoseChangeDetector(thresholds);
+}
+
+//-----------------------------------------------------------------------------
+size_t PathMatching::getNumberOfSkippedResearches() const
+{
+  return numberOfSkippedResearches_;
+}
+
+//-----------------------------------------------------------------------------
+size_t PathMatching::getNumberOfGlobalResearches() const
+{
+  return numberOfGlobalResearches_;
 }
 
 //-----------------------------------------------------------------------------
 DiagnosticReport PathMatching::getReport(const Duration & stamp)
 {
-  return diagnostics_.makeReport(stamp);
+  return std::visit(
+    [&stamp](auto & diagnostics) {return diagnostics.makeReport(stamp);}, diagnostics_);
 }
 
 //-----------------------------------------------------------------------------
 void PathMatching::reset()
 {
   matchedPoints_.clear();
+  matchedPointsAnnotations_.clear();
+  changeDetector_.reset();
 }
 
 }  // namespace core
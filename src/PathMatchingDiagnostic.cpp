@@ -18,6 +18,7 @@
 
 // romea
 #include "romea_core_path_matching/PathMatchingDiagnostic.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
 
 namespace
 {
@@ -39,12 +40,7 @@ PathMatchingDiagnostic::PathMatchingDiagnostic(const std::string & pathFilename)
   pathMatchingStatus_()
 {
   setReportInfo(pathMatchingStatus_, "path_matching", "");
-  setReportInfo(
-    pathFilename_, "path_file_directory",
-    pathFilename.substr(0, pathFilename.find_last_of('/')));
-  setReportInfo(
-    pathFilename_, "path_file_name",
-    pathFilename.substr(pathFilename.find_last_of('/') + 1));
+  setPathFilename(pathFilename);
 }
 
 
@@ -69,9 +65,21 @@ void PathMatchingDiagnostic::updatePathMatchingStatus(const bool & status)
 }
 
 
+//-----------------------------------------------------------------------------
+void PathMatchingDiagnostic::setPathFilename(const std::string & pathFilename)
+{
+  setReportInfo(
+    pathFilename_, "path_file_directory",
+    pathFilename.substr(0, pathFilename.find_last_of('/')));
+  setReportInfo(
+    pathFilename_, "path_file_name",
+    pathFilename.substr(pathFilename.find_last_of('/') + 1));
+}
+
 //-----------------------------------------------------------------------------
 DiagnosticReport PathMatchingDiagnostic::makeReport(const core::Duration & duration)
 {
+  ROMEA_PATH_MATCHING_TRACE_SCOPE("PathMatchingDiagnostic::makeReport");
   if (!localisationRateDiagnostic_.heartBeatCallback(duration)) {
     pathMatchingStatus_.diagnostics.clear();
     setReportInfo(pathMatchingStatus_, "path_matching", "");
@@ -0,0 +1,540 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+// romea
+#include "romea_core_path/PathSectionMatching2D.hpp"
+#include "romea_core_path_matching/PathPostureTable.hpp"
+
+namespace
+{
+double betweenMinusPiAndPi(const double & angle)
+{
+  return angle - 2 * M_PI * std::floor((angle + M_PI) / (2 * M_PI));
+}
+
+// Curve posture of a section at a polyline point, the curve is matched around the
+// posture of the previous sample of the section when there is one
+void pushPosture(
+  const romea::core::PathSection2D & section,
+  const romea::core::Pose2D & polylinePose,
+  const double & samplingStep,
+  const double & interpolationWindowLength,
+  std::optional<romea::core::PathMatchedPoint2D> & matchedPoint,
+  romea::core::PathPostures2D & samples)
+{
+  const double researchRadius = interpolationWindowLength + samplingStep;
+  if (matchedPoint.has_value()) {
+    matchedPoint = romea::core::match(
+      section, polylinePose, 0., *matchedPoint, researchRadius, 0., researchRadius);
+  } else {
+    matchedPoint = romea::core::match(section, polylinePose, 0., 0., researchRadius);
+  }
+
+  // course of the polyline is kept when no curve is found near it
+  romea::core::PathPosture2D posture;
+  if (matchedPoint.has_value()) {
+    posture = matchedPoint->pathPosture;
+  } else {
+    posture.position = polylinePose.position;
+    posture.course = polylinePose.yaw;
+    posture.curvature = 0;
+    posture.dotCurvature = 0;
+  }
+
+  // course is stored unwrapped to be linearly interpolated
+  const size_t n = samples.size();
+  samples.x.push_back(posture.position.x());
+  samples.y.push_back(posture.position.y());
+  samples.course.push_back(n == 0 ? posture.course :
+    samples.course[n - 1] + betweenMinusPiAndPi(posture.course - samples.course[n - 1]));
+  samples.curvature.push_back(posture.curvature);
+  samples.dotCurvature.push_back(posture.dotCurvature);
+}
+
+// Postures of the curves interpolated by each section, sampled every samplingStep along
+// the polylines of all sections. Samples before firstSampleIndex are kept as is and
+// sections after lastSampledSectionIndex are only counted, the number of samples of
+// the whole path is returned.
+size_t samplePostures(
+  const romea::core::Path2D & path,
+  const double & samplingStep,
+  const double & interpolationWindowLength,
+  const size_t & firstSampleIndex,
+  const size_t & lastSampledSectionIndex,
+  romea::core::PathPostures2D & samples,
+  std::vector<size_t> & sectionFirstSamples)
+{
+  samples.resize(std::min(firstSampleIndex, samples.size()));
+  sectionFirstSamples.clear();
+
+  double sectionInitialAbscissa = 0;
+  size_t sampleIndex = 0;
+
+  for (size_t s = 0; s < path.size(); ++s) {
+    const auto & section = path.getSection(s);
+    const auto & X = section.getX();
+    const auto & Y = section.getY();
+    sectionFirstSamples.push_back(sampleIndex);
+
+    std::optional<romea::core::PathMatchedPoint2D> matchedPoint;
+    double abscissa = sectionInitialAbscissa;
+    for (size_t n = 1; n < X.size(); ++n) {
+      double dx = X[n] - X[n - 1];
+      double dy = Y[n] - Y[n - 1];
+      double length = std::sqrt(dx * dx + dy * dy);
+
+      while (length > 0 && sampleIndex * samplingStep <= abscissa + length) {
+        if (sampleIndex >= samples.size() && s <= lastSampledSectionIndex) {
+          double t = (sampleIndex * samplingStep - abscissa) / length;
+          romea::core::Pose2D polylinePose;
+          polylinePose.position = Eigen::Vector2d(X[n - 1] + t * dx, Y[n - 1] + t * dy);
+          polylinePose.yaw = std::atan2(dy, dx);
+          pushPosture(
+            section, polylinePose, samplingStep, interpolationWindowLength,
+            matchedPoint, samples);
+        }
+        ++sampleIndex;
+      }
+      abscissa += length;
+    }
+    sectionInitialAbscissa = abscissa;
+  }
+
+  if (sampleIndex < 2) {
+    samples.resize(0);
+    sectionFirstSamples.clear();
+    return 0;
+  }
+  return sampleIndex;
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+void PathPostures2D::resize(const size_t & size)
+{
+  x.resize(size);
+  y.resize(size);
+  course.resize(size);
+  curvature.resize(size);
+  dotCurvature.resize(size);
+}
+
+//-----------------------------------------------------------------------------
+size_t PathPostures2D::size() const
+{
+  return x.size();
+}
+
+//-----------------------------------------------------------------------------
+bool CompactPathPostures2D::encode(const PathPostures2D & postures, const double & samplingStep)
+{
+  // samples of a block are less than 32 m away from its origin
+  blockSize = std::clamp<size_t>(static_cast<size_t>(32. / samplingStep), 1, 256);
+
+  const size_t size = postures.size();
+  blocks.clear();
+  x.resize(size);
+  y.resize(size);
+  course.resize(size);
+  curvature.resize(size);
+  dotCurvature.resize(size);
+
+  for (size_t first = 0; first < size; first += blockSize) {
+    const size_t last = std::min(first + blockSize, size);
+
+    Block block{postures.x[first], postures.y[first], 0, 0};
+    for (size_t n = first; n < last; ++n) {
+      block.curvatureStep = std::max(block.curvatureStep, std::abs(postures.curvature[n]));
+      block.dotCurvatureStep = std::max(block.dotCurvatureStep, std::abs(postures.dotCurvature[n]));
+    }
+    block.curvatureStep = block.curvatureStep > 0 ? block.curvatureStep / INT16_MAX : 1;
+    block.dotCurvatureStep = block.dotCurvatureStep > 0 ? block.dotCurvatureStep / INT16_MAX : 1;
+
+    for (size_t n = first; n < last; ++n) {
+      const int64_t dx = std::llround((postures.x[n] - block.x) / POSITION_QUANTIZATION_STEP);
+      const int64_t dy = std::llround((postures.y[n] - block.y) / POSITION_QUANTIZATION_STEP);
+      if (std::max(std::abs(dx), std::abs(dy)) > INT16_MAX) {
+        return false;
+      }
+
+      x[n] = static_cast<int16_t>(dx);
+      y[n] = static_cast<int16_t>(dy);
+      // 16 bit wrapping keeps course modulo a turn
+      course[n] = static_cast<uint16_t>(
+        std::llround(postures.course[n] / COURSE_QUANTIZATION_STEP));
+      curvature[n] = static_cast<int16_t>(
+        std::lround(postures.curvature[n] / block.curvatureStep));
+      dotCurvature[n] = static_cast<int16_t>(
+        std::lround(postures.dotCurvature[n] / block.dotCurvatureStep));
+    }
+    blocks.push_back(block);
+  }
+
+  blocks.shrink_to_fit();
+  x.shrink_to_fit();
+  y.shrink_to_fit();
+  course.shrink_to_fit();
+  curvature.shrink_to_fit();
+  dotCurvature.shrink_to_fit();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void CompactPathPostures2D::decode(PathPostures2D & postures) const
+{
+  postures.resize(size());
+
+  PathPosture2D posture;
+  for (size_t n = 0; n < size(); ++n) {
+    decode(n, posture);
+    postures.x[n] = posture.position.x();
+    postures.y[n] = posture.position.y();
+    postures.curvature[n] = posture.curvature;
+    postures.dotCurvature[n] = posture.dotCurvature;
+    // course is unwrapped as in the full precision table
+    postures.course[n] = n == 0 ? betweenMinusPiAndPi(posture.course) :
+      postures.course[n - 1] + betweenMinusPiAndPi(posture.course - postures.course[n - 1]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void CompactPathPostures2D::decode(const size_t & index, PathPosture2D & posture) const
+{
+  const Block & block = blocks[index / blockSize];
+  posture.position.x() = block.x + x[index] * POSITION_QUANTIZATION_STEP;
+  posture.position.y() = block.y + y[index] * POSITION_QUANTIZATION_STEP;
+  posture.course = course[index] * COURSE_QUANTIZATION_STEP;
+  posture.curvature = curvature[index] * block.curvatureStep;
+  posture.dotCurvature = dotCurvature[index] * block.dotCurvatureStep;
+}
+
+//-----------------------------------------------------------------------------
+size_t CompactPathPostures2D::size() const
+{
+  return x.size();
+}
+
+//-----------------------------------------------------------------------------
+PathPostureTable::PathPostureTable()
+: samplingStep_(0),
+  interpolationWindowLength_(0),
+  minimalCurvilinearAbscissa_(0),
+  sectionFirstSamples_(),
+  sectionFirstSampleFlags_(),
+  samples_(),
+  compactSamples_(),
+  isCompact_(false)
+{
+}
+
+//-----------------------------------------------------------------------------
+PathPostureTable::PathPostureTable(
+  const Path2D & path,
+  const double & samplingStep,
+  const double & interpolationWindowLength)
+: samplingStep_(samplingStep),
+  interpolationWindowLength_(interpolationWindowLength),
+  minimalCurvilinearAbscissa_(0),
+  sectionFirstSamples_(),
+  sectionFirstSampleFlags_(),
+  samples_(),
+  compactSamples_(),
+  isCompact_(false)
+{
+  samplePostures(
+    path, samplingStep_, interpolationWindowLength_, 0, path.size(),
+    samples_, sectionFirstSamples_);
+  flagSectionFirstSamples_();
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::update(const Path2D & path, const double & curvilinearAbscissa)
+{
+  // splices are rare, samples are just expanded then compacted again
+  if (isCompact_) {
+    compactSamples_.decode(samples_);
+    isCompact_ = false;
+    update(path, curvilinearAbscissa);
+    compact();
+    return;
+  }
+
+  samplePostures(
+    path, samplingStep_, interpolationWindowLength_, firstUpdatedSample_(curvilinearAbscissa),
+    path.size(), samples_, sectionFirstSamples_);
+  flagSectionFirstSamples_();
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::update(
+  const Path2D & path,
+  const size_t & sectionIndex,
+  const double & curvilinearAbscissa,
+  const double & lengthOffset)
+{
+  if (isCompact_) {
+    compactSamples_.decode(samples_);
+    isCompact_ = false;
+    update(path, sectionIndex, curvilinearAbscissa, lengthOffset);
+    compact();
+    return;
+  }
+
+  // nothing to move postures from
+  if (empty() || sectionIndex + 1 >= sectionFirstSamples_.size()) {
+    update(path, curvilinearAbscissa);
+    return;
+  }
+
+  // samples are copied rather than matched again on the curves of following sections
+  const PathPostureTable previousTable = *this;
+  const double followingSectionAbscissa = minimalCurvilinearAbscissa_ +
+    sectionFirstSamples_[sectionIndex + 1] * samplingStep_;
+
+  const size_t numberOfSamples = samplePostures(
+    path, samplingStep_, interpolationWindowLength_, firstUpdatedSample_(curvilinearAbscissa),
+    sectionIndex, samples_, sectionFirstSamples_);
+
+  // moved abscissas are clamped so that no sample is taken in the spliced section
+  const size_t firstMovedSample = samples_.size();
+  samples_.resize(numberOfSamples);
+  for (size_t n = firstMovedSample; n < numberOfSamples; ++n) {
+    const double abscissa = minimalCurvilinearAbscissa_ + n * samplingStep_ - lengthOffset;
+    previousTable.lookup_(std::max(abscissa, followingSectionAbscissa), samples_, n);
+    if (n > 0) {
+      samples_.course[n] = samples_.course[n - 1] +
+        betweenMinusPiAndPi(samples_.course[n] - samples_.course[n - 1]);
+    }
+  }
+  flagSectionFirstSamples_();
+}
+
+//-----------------------------------------------------------------------------
+bool PathPostureTable::compact()
+{
+  if (isCompact_) {
+    return true;
+  }
+
+  // encoded aside so that a path with a gap leaves full precision samples untouched
+  CompactPathPostures2D compactSamples;
+  if (!compactSamples.encode(samples_, samplingStep_)) {
+    return false;
+  }
+
+  compactSamples_ = std::move(compactSamples);
+  samples_ = PathPostures2D();
+  isCompact_ = true;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool PathPostureTable::isCompact() const
+{
+  return isCompact_;
+}
+
+//-----------------------------------------------------------------------------
+size_t PathPostureTable::getMemoryUsage() const
+{
+  const size_t flagsMemoryUsage = sectionFirstSampleFlags_.capacity() / 8;
+  if (isCompact_) {
+    return compactSamples_.blocks.capacity() * sizeof(CompactPathPostures2D::Block) +
+           compactSamples_.x.capacity() * sizeof(int16_t) +
+           compactSamples_.y.capacity() * sizeof(int16_t) +
+           compactSamples_.course.capacity() * sizeof(uint16_t) +
+           compactSamples_.curvature.capacity() * sizeof(int16_t) +
+           compactSamples_.dotCurvature.capacity() * sizeof(int16_t) + flagsMemoryUsage;
+  }
+
+  return (samples_.x.capacity() + samples_.y.capacity() + samples_.course.capacity() +
+         samples_.curvature.capacity() + samples_.dotCurvature.capacity()) * sizeof(double) +
+         flagsMemoryUsage;
+}
+
+//-----------------------------------------------------------------------------
+PathPosture2D PathPostureTable::lookup(const double & curvilinearAbscissa) const
+{
+  checkIsNotEmpty_();
+
+  PathPostures2D postures;
+  postures.resize(1);
+  lookup_(curvilinearAbscissa, postures, 0);
+
+  PathPosture2D posture;
+  posture.position.x() = postures.x[0];
+  posture.position.y() = postures.y[0];
+  posture.course = postures.course[0];
+  posture.curvature = postures.curvature[0];
+  posture.dotCurvature = postures.dotCurvature[0];
+  return posture;
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::lookup(
+  const std::vector<double> & curvilinearAbscissas,
+  PathPostures2D & postures) const
+{
+  checkIsNotEmpty_();
+
+  postures.resize(curvilinearAbscissas.size());
+  for (size_t n = 0; n < curvilinearAbscissas.size(); ++n) {
+    lookup_(curvilinearAbscissas[n], postures, n);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::lookup(
+  const double & initialCurvilinearAbscissa,
+  const double & curvilinearAbscissaStep,
+  const size_t & numberOfPostures,
+  PathPostures2D & postures) const
+{
+  checkIsNotEmpty_();
+
+  postures.resize(numberOfPostures);
+  for (size_t n = 0; n < numberOfPostures; ++n) {
+    lookup_(initialCurvilinearAbscissa + n * curvilinearAbscissaStep, postures, n);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::lookup_(
+  const double & curvilinearAbscissa,
+  PathPostures2D & postures,
+  const size_t & n) const
+{
+  const size_t size = size_();
+  const double last = static_cast<double>(size - 1);
+  const double index = std::clamp(
+    (curvilinearAbscissa - minimalCurvilinearAbscissa_) / samplingStep_, 0., last);
+  size_t i = std::min(static_cast<size_t>(index), size - 2);
+  size_t j = i + 1;
+  double t = index - i;
+
+  // postures are not interpolated from one section to the next one, the nearest
+  // sample is used instead since direction of motion may be reversed in between
+  if (sectionFirstSampleFlags_[j]) {
+    i = j = t < 0.5 ? i : j;
+    t = 0;
+  }
+
+  if (isCompact_) {
+    PathPosture2D first;
+    PathPosture2D second;
+    compactSamples_.decode(i, first);
+    compactSamples_.decode(j, second);
+
+    postures.x[n] = first.position.x() + t * (second.position.x() - first.position.x());
+    postures.y[n] = first.position.y() + t * (second.position.y() - first.position.y());
+    postures.course[n] = betweenMinusPiAndPi(
+      first.course + t * betweenMinusPiAndPi(second.course - first.course));
+    postures.curvature[n] = first.curvature + t * (second.curvature - first.curvature);
+    postures.dotCurvature[n] = first.dotCurvature +
+      t * (second.dotCurvature - first.dotCurvature);
+    return;
+  }
+
+  postures.x[n] = samples_.x[i] + t * (samples_.x[j] - samples_.x[i]);
+  postures.y[n] = samples_.y[i] + t * (samples_.y[j] - samples_.y[i]);
+  postures.course[n] = betweenMinusPiAndPi(
+    samples_.course[i] + t * (samples_.course[j] - samples_.course[i]));
+  postures.curvature[n] = samples_.curvature[i] +
+    t * (samples_.curvature[j] - samples_.curvature[i]);
+  postures.dotCurvature[n] = samples_.dotCurvature[i] +
+    t * (samples_.dotCurvature[j] - samples_.dotCurvature[i]);
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::flagSectionFirstSamples_()
+{
+  sectionFirstSampleFlags_.assign(size_(), false);
+  for (const size_t & index : sectionFirstSamples_) {
+    if (index < sectionFirstSampleFlags_.size()) {
+      sectionFirstSampleFlags_[index] = true;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathPostureTable::checkIsNotEmpty_() const
+{
+  if (empty()) {
+    throw std::runtime_error("Path posture table is empty, path is too short to be sampled");
+  }
+}
+
+//-----------------------------------------------------------------------------
+double PathPostureTable::getSamplingStep() const
+{
+  return samplingStep_;
+}
+
+//-----------------------------------------------------------------------------
+double PathPostureTable::getMinimalCurvilinearAbscissa() const
+{
+  return minimalCurvilinearAbscissa_;
+}
+
+//-----------------------------------------------------------------------------
+double PathPostureTable::getMaximalCurvilinearAbscissa() const
+{
+  return empty() ? minimalCurvilinearAbscissa_ :
+         minimalCurvilinearAbscissa_ + (size_() - 1) * samplingStep_;
+}
+
+//-----------------------------------------------------------------------------
+const PathPostures2D & PathPostureTable::getSamples() const
+{
+  return samples_;
+}
+
+//-----------------------------------------------------------------------------
+bool PathPostureTable::empty() const
+{
+  return size_() == 0;
+}
+
+//-----------------------------------------------------------------------------
+size_t PathPostureTable::size_() const
+{
+  return isCompact_ ? compactSamples_.size() : samples_.size();
+}
+
+//-----------------------------------------------------------------------------
+size_t PathPostureTable::firstUpdatedSample_(const double & curvilinearAbscissa) const
+{
+  // curves are interpolated over a window, they change before the first moved way point
+  const double index = (curvilinearAbscissa - interpolationWindowLength_ -
+    minimalCurvilinearAbscissa_) / samplingStep_;
+  return std::min(samples_.size(), static_cast<size_t>(std::max(0., std::floor(index))));
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,218 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PathProjector.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+void PathFrenetCoordinates2D::resize(const size_t & size)
+{
+  curvilinearAbscissa.resize(size);
+  lateralDeviation.resize(size);
+  sectionIndex.resize(size);
+}
+
+//-----------------------------------------------------------------------------
+size_t PathFrenetCoordinates2D::size() const
+{
+  return curvilinearAbscissa.size();
+}
+
+//-----------------------------------------------------------------------------
+PathProjector::PathProjector(
+  const Path2D & path,
+  const CoarsePathIndex & pathIndex,
+  const PathAbscissaIndex & abscissaIndex)
+: path_(path),
+  pathIndex_(pathIndex),
+  abscissaIndex_(abscissaIndex)
+{
+}
+
+//-----------------------------------------------------------------------------
+void PathProjector::project(
+  const std::vector<Eigen::Vector2d> & points,
+  const double & maximalResearchRadius,
+  PathFrenetCoordinates2D & coordinates) const
+{
+  coordinates.resize(points.size());
+  project_(points, maximalResearchRadius, 0, points.size(), coordinates);
+}
+
+//-----------------------------------------------------------------------------
+void PathProjector::project(
+  const std::vector<Eigen::Vector2d> & points,
+  const double & maximalResearchRadius,
+  PathFrenetCoordinates2D & coordinates,
+  const Executor & executor,
+  const size_t & numberOfTasks) const
+{
+  coordinates.resize(points.size());
+
+  const size_t numberOfRanges = std::clamp<size_t>(
+    points.size() / MINIMAL_NUMBER_OF_POINTS_PER_TASK, 1, std::max<size_t>(numberOfTasks, 1));
+  const size_t pointsPerRange = (points.size() + numberOfRanges - 1) / numberOfRanges;
+
+  // each task writes its own range of coordinates
+  executor(
+    numberOfRanges, [&](size_t n) {
+      const size_t first = std::min(n * pointsPerRange, points.size());
+      const size_t last = std::min(first + pointsPerRange, points.size());
+      project_(points, maximalResearchRadius, first, last, coordinates);
+    });
+}
+
+//-----------------------------------------------------------------------------
+void PathProjector::project_(
+  const std::vector<Eigen::Vector2d> & points,
+  const double & maximalResearchRadius,
+  const size_t & first,
+  const size_t & last,
+  PathFrenetCoordinates2D & coordinates) const
+{
+  const double squaredMaximalResearchRadius = maximalResearchRadius * maximalResearchRadius;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  Projection projection;
+  bool found = false;
+
+  for (size_t n = first; n < last; ++n) {
+    // projection near the previous one bounds the radius of the coarse research
+    double researchRadius = maximalResearchRadius;
+    if (found) {
+      projectLocally_(points[n], projection);
+      researchRadius = std::min(researchRadius, std::sqrt(projection.squaredDistance));
+    } else {
+      projection.squaredDistance = std::numeric_limits<double>::max();
+    }
+
+    projectGlobally_(points[n], researchRadius, chunks, projection);
+    found = projection.squaredDistance <= squaredMaximalResearchRadius;
+
+    if (found) {
+      coordinates.curvilinearAbscissa[n] = projection.curvilinearAbscissa;
+      coordinates.lateralDeviation[n] = projection.lateralDeviation;
+      coordinates.sectionIndex[n] = projection.sectionIndex;
+    } else {
+      coordinates.curvilinearAbscissa[n] = std::numeric_limits<double>::quiet_NaN();
+      coordinates.lateralDeviation[n] = std::numeric_limits<double>::quiet_NaN();
+      coordinates.sectionIndex[n] = PathFrenetCoordinates2D::INVALID_SECTION_INDEX;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void PathProjector::projectLocally_(
+  const Eigen::Vector2d & point,
+  Projection & projection) const
+{
+  const size_t sectionLast = path_.getSection(projection.sectionIndex).size() - 1;
+  const size_t seed = projection.wayPointIndex;
+
+  const size_t first = seed > LOCAL_RESEARCH_HALF_WINDOW ? seed - LOCAL_RESEARCH_HALF_WINDOW : 0;
+  const size_t last = std::min(seed + LOCAL_RESEARCH_HALF_WINDOW + 1, sectionLast);
+
+  projection.squaredDistance = std::numeric_limits<double>::max();
+  projectOnSegments_(point, projection.sectionIndex, first, last, projection);
+}
+
+//-----------------------------------------------------------------------------
+void PathProjector::projectGlobally_(
+  const Eigen::Vector2d & point,
+  const double & researchRadius,
+  std::vector<std::pair<size_t, size_t>> & chunks,
+  Projection & projection) const
+{
+  for (size_t s = 0; s < pathIndex_.size(); ++s) {
+    pathIndex_.findCandidateChunks(s, point, researchRadius, chunks);
+    for (const auto & [first, last] : chunks) {
+      if (projectOnSegments_(point, s, first, last, projection)) {
+        projection.sectionIndex = s;
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool PathProjector::projectOnSegments_(
+  const Eigen::Vector2d & point,
+  const size_t & sectionIndex,
+  const size_t & firstWayPointIndex,
+  const size_t & lastWayPointIndex,
+  Projection & projection) const
+{
+  // way points are read from the path itself rather than from a copy
+  const auto & X = path_.getSection(sectionIndex).getX();
+  const auto & Y = path_.getSection(sectionIndex).getY();
+  const double px = point.x();
+  const double py = point.y();
+
+  // nearest segment is first found on contiguous arrays, Frenet coordinates are then
+  // only computed once
+  double bestSquaredDistance = projection.squaredDistance;
+  size_t bestIndex = lastWayPointIndex;
+  for (size_t n = firstWayPointIndex; n < lastWayPointIndex; ++n) {
+    const double dx = X[n + 1] - X[n];
+    const double dy = Y[n + 1] - Y[n];
+    const double ux = px - X[n];
+    const double uy = py - Y[n];
+    const double squaredLength = dx * dx + dy * dy;
+    const double t = squaredLength > 0 ?
+      std::clamp((ux * dx + uy * dy) / squaredLength, 0., 1.) : 0.;
+    const double ex = ux - t * dx;
+    const double ey = uy - t * dy;
+    const double squaredDistance = ex * ex + ey * ey;
+    if (squaredDistance < bestSquaredDistance) {
+      bestSquaredDistance = squaredDistance;
+      bestIndex = n;
+    }
+  }
+
+  if (bestIndex == lastWayPointIndex) {
+    return false;
+  }
+
+  const size_t n = bestIndex;
+  const double dx = X[n + 1] - X[n];
+  const double dy = Y[n + 1] - Y[n];
+  const double ux = px - X[n];
+  const double uy = py - Y[n];
+  const double squaredLength = dx * dx + dy * dy;
+  const double t = squaredLength > 0 ?
+    std::clamp((ux * dx + uy * dy) / squaredLength, 0., 1.) : 0.;
+  const double distance = std::sqrt(bestSquaredDistance);
+  const double * curvilinearAbscissas = abscissaIndex_.getCurvilinearAbscissas().data() +
+    abscissaIndex_.getSectionOffset(sectionIndex);
+
+  projection.squaredDistance = bestSquaredDistance;
+  projection.curvilinearAbscissa = curvilinearAbscissas[n] +
+    t * (curvilinearAbscissas[n + 1] - curvilinearAbscissas[n]);
+  projection.lateralDeviation = dx * uy - dy * ux < 0 ? -distance : distance;
+  projection.wayPointIndex = n;
+  return true;
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,137 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+// romea
+#include "romea_core_common/math/EulerAngles.hpp"
+#include "romea_core_path_matching/PoseChangeDetector.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+PoseChangeDetector::PoseChangeDetector()
+: thresholds_(),
+  referencePose_(),
+  referenceTwist_(),
+  referencePredictionTimeHorizon_(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+PoseChangeDetector::PoseChangeDetector(const PoseChangeThresholds & thresholds)
+: thresholds_(thresholds),
+  referencePose_(),
+  referenceTwist_(),
+  referencePredictionTimeHorizon_(0)
+{
+  if (thresholds.position < 0 || thresholds.yaw < 0 ||
+    thresholds.linearSpeed < 0 || thresholds.angularSpeed < 0)
+  {
+    throw std::invalid_argument("Pose change thresholds must be positive");
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool PoseChangeDetector::hasChanged(
+  const Pose2D & vehiclePose,
+  const Twist2D & vehicleTwist,
+  const double & predictionTimeHorizon) const
+{
+  if (!thresholds_.has_value() || !referencePose_.has_value() ||
+    predictionTimeHorizon != referencePredictionTimeHorizon_)
+  {
+    return true;
+  }
+
+  return (vehiclePose.position - referencePose_->position).norm() > thresholds_->position ||
+         std::abs(betweenMinusPiAndPi(vehiclePose.yaw - referencePose_->yaw)) > thresholds_->yaw ||
+         (vehicleTwist.linearSpeeds - referenceTwist_.linearSpeeds).norm() >
+         thresholds_->linearSpeed ||
+         std::abs(vehicleTwist.angularSpeed - referenceTwist_.angularSpeed) >
+         thresholds_->angularSpeed;
+}
+
+//-----------------------------------------------------------------------------
+void PoseChangeDetector::setReference(
+  const Pose2D & vehiclePose,
+  const Twist2D & vehicleTwist,
+  const double & predictionTimeHorizon)
+{
+  referencePose_ = vehiclePose;
+  referenceTwist_ = vehicleTwist;
+  referencePredictionTimeHorizon_ = predictionTimeHorizon;
+}
+
+//-----------------------------------------------------------------------------
+void PoseChangeDetector::reset()
+{
+  referencePose_.reset();
+}
+
+//-----------------------------------------------------------------------------
+bool PoseChangeDetector::isEnabled() const
+{
+  return thresholds_.has_value();
+}
+
+//-----------------------------------------------------------------------------
+std::optional<PathMatchedPoint2D> extrapolateMatchedPoint(
+  const PathSection2D & section,
+  const PathMatchedPoint2D & matchedPoint,
+  const Pose2D & vehiclePose)
+{
+  const auto & X = section.getX();
+  const auto & Y = section.getY();
+  const size_t wayPointIndex = matchedPoint.curveIndex;
+  if (wayPointIndex >= X.size()) {
+    return std::nullopt;
+  }
+
+  const double course = matchedPoint.pathPosture.course;
+  const Eigen::Vector2d tangent(std::cos(course), std::sin(course));
+  const Eigen::Vector2d offset = vehiclePose.position - matchedPoint.pathPosture.position;
+  const double longitudinalOffset = tangent.dot(offset);
+
+  // curve is interpolated around its way point, it is left past the neighbouring ones
+  const Eigen::Vector2d wayPoint(X[wayPointIndex], Y[wayPointIndex]);
+  const double wayPointOffset = longitudinalOffset +
+    tangent.dot(matchedPoint.pathPosture.position - wayPoint);
+  const double minimalWayPointOffset = wayPointIndex > 0 ?
+    -(wayPoint - Eigen::Vector2d(X[wayPointIndex - 1], Y[wayPointIndex - 1])).norm() : 0;
+  const double maximalWayPointOffset = wayPointIndex + 1 < X.size() ?
+    (Eigen::Vector2d(X[wayPointIndex + 1], Y[wayPointIndex + 1]) - wayPoint).norm() : 0;
+  if (wayPointOffset < minimalWayPointOffset || wayPointOffset > maximalWayPointOffset) {
+    return std::nullopt;
+  }
+
+  // lateral deviation is positive on the left of the path
+  PathMatchedPoint2D extrapolatedPoint = matchedPoint;
+  extrapolatedPoint.pathPosture.position += longitudinalOffset * tangent;
+  extrapolatedPoint.frenetPose.curvilinearAbscissa += longitudinalOffset;
+  extrapolatedPoint.frenetPose.lateralDeviation =
+    tangent.x() * offset.y() - tangent.y() * offset.x();
+  extrapolatedPoint.frenetPose.courseDeviation = betweenMinusPiAndPi(vehiclePose.yaw - course);
+  return extrapolatedPoint;
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,202 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+#include "romea_core_path_matching/PathMatching.hpp"
+#include "romea_core_path_matching/PoseStreamPipeline.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+PoseStreamPipeline::PoseStreamPipeline(
+  LeaderHandler leaderHandler,
+  FollowerHandler followerHandler,
+  const size_t & maximalNumberOfPendingLeaderPoses)
+: leaderHandler_(std::move(leaderHandler)),
+  followerHandler_(std::move(followerHandler)),
+  maximalNumberOfPendingLeaderPoses_(std::max<size_t>(maximalNumberOfPendingLeaderPoses, 1)),
+  mutex_(),
+  workAvailable_(),
+  workDone_(),
+  pendingLeaderPoses_(),
+  pendingFollowerPose_(),
+  numberOfDroppedFollowerPoses_(0),
+  busy_(false),
+  stopped_(false),
+  error_(),
+  worker_(&PoseStreamPipeline::run_, this)
+{
+}
+
+//-----------------------------------------------------------------------------
+PoseStreamPipeline::~PoseStreamPipeline()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  workAvailable_.notify_one();
+  worker_.join();
+}
+
+//-----------------------------------------------------------------------------
+void PoseStreamPipeline::pushLeaderPose(
+  const Duration & stamp,
+  const Pose2D & pose,
+  const Twist2D & twist)
+{
+  if (!leaderHandler_) {
+    throw std::logic_error("Pose stream pipeline has no leader stream");
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    workDone_.wait(
+      lock, [this]() {
+        return pendingLeaderPoses_.size() < maximalNumberOfPendingLeaderPoses_;
+      });
+    pendingLeaderPoses_.push_back({stamp, pose, twist});
+  }
+  workAvailable_.notify_one();
+}
+
+//-----------------------------------------------------------------------------
+void PoseStreamPipeline::pushFollowerPose(
+  const Duration & stamp,
+  const Pose2D & pose,
+  const Twist2D & twist)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    numberOfDroppedFollowerPoses_ += pendingFollowerPose_.has_value();
+    pendingFollowerPose_ = PoseSample{stamp, pose, twist};
+  }
+  workAvailable_.notify_one();
+}
+
+//-----------------------------------------------------------------------------
+void PoseStreamPipeline::flush()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  workDone_.wait(
+    lock, [this]() {
+      return !busy_ && pendingLeaderPoses_.empty() && !pendingFollowerPose_.has_value();
+    });
+
+  if (error_) {
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+}
+
+//-----------------------------------------------------------------------------
+size_t PoseStreamPipeline::getNumberOfDroppedFollowerPoses() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numberOfDroppedFollowerPoses_;
+}
+
+//-----------------------------------------------------------------------------
+void PoseStreamPipeline::run_()
+{
+  std::vector<PoseSample> leaderPoses;
+  std::optional<PoseSample> followerPose;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    workAvailable_.wait(
+      lock, [this]() {
+        return stopped_ || !pendingLeaderPoses_.empty() || pendingFollowerPose_.has_value();
+      });
+
+    if (pendingLeaderPoses_.empty() && !pendingFollowerPose_.has_value()) {
+      return;
+    }
+
+    // buffers are swapped so their capacity is reused from one batch to the next
+    leaderPoses.clear();
+    std::swap(leaderPoses, pendingLeaderPoses_);
+    followerPose = std::exchange(pendingFollowerPose_, std::nullopt);
+    busy_ = true;
+    lock.unlock();
+    workDone_.notify_all();
+
+    std::exception_ptr error;
+    try {
+      if (!leaderPoses.empty()) {
+        leaderHandler_(leaderPoses);
+      }
+      if (followerPose.has_value()) {
+        followerHandler_(*followerPose);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    busy_ = false;
+    if (error && !error_) {
+      error_ = error;
+    }
+    workDone_.notify_all();
+  }
+}
+
+//-----------------------------------------------------------------------------
+std::unique_ptr<PoseStreamPipeline> makePoseStreamPipeline(
+  OnTheFlyPathMatching & matching,
+  std::function<void(const Duration &, const std::optional<PathMatchedPoint2D> &)> callback)
+{
+  return std::make_unique<PoseStreamPipeline>(
+    [&matching](const std::vector<PoseSample> & leaderPoses) {
+      for (const auto & leaderPose : leaderPoses) {
+        matching.updatePath(leaderPose.stamp, leaderPose.pose, leaderPose.twist);
+      }
+    },
+    [&matching, callback = std::move(callback)](const PoseSample & followerPose) {
+      callback(
+        followerPose.stamp,
+        matching.match(followerPose.stamp, followerPose.pose, followerPose.twist));
+    });
+}
+
+//-----------------------------------------------------------------------------
+std::unique_ptr<PoseStreamPipeline> makePoseStreamPipeline(
+  PathMatching & matching,
+  const double & predictionTimeHorizon,
+  std::function<void(const Duration &, const std::vector<PathMatchedPoint2D> &)> callback)
+{
+  return std::make_unique<PoseStreamPipeline>(
+    nullptr,
+    [&matching, predictionTimeHorizon, callback = std::move(callback)](
+      const PoseSample & followerPose) {
+      callback(
+        followerPose.stamp,
+        matching.match(
+          followerPose.stamp, followerPose.pose, followerPose.twist, predictionTimeHorizon));
+    });
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,113 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// std
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/StreamingPathSimplifier.hpp"
+
+namespace
+{
+double distanceToSegment(
+  const Eigen::Vector2d & point,
+  const Eigen::Vector2d & begin,
+  const Eigen::Vector2d & end)
+{
+  Eigen::Vector2d segment = end - begin;
+  double squaredLength = segment.squaredNorm();
+  if (squaredLength == 0) {
+    return (point - begin).norm();
+  }
+  double t = std::clamp((point - begin).dot(segment) / squaredLength, 0., 1.);
+  return (point - begin - t * segment).norm();
+}
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+StreamingPathSimplifier::StreamingPathSimplifier(
+  const double & maximalLateralError,
+  const double & maximalDistanceBetweenTwoPoints)
+: maximalLateralError_(maximalLateralError),
+  maximalDistanceBetweenTwoPoints_(maximalDistanceBetweenTwoPoints),
+  lastKeptPoint_(),
+  pendingPoints_()
+{
+}
+
+//-----------------------------------------------------------------------------
+std::optional<Eigen::Vector2d> StreamingPathSimplifier::update(const Eigen::Vector2d & position)
+{
+  if (!lastKeptPoint_.has_value() ||
+    (pendingPoints_.empty() && !canSkipPendingPoints_(position)))
+  {
+    lastKeptPoint_ = position;
+    return position;
+  }
+
+  if (canSkipPendingPoints_(position)) {
+    pendingPoints_.push_back(position);
+    return std::nullopt;
+  }
+
+  // the previous point is the farthest one that still fits the tolerance
+  lastKeptPoint_ = pendingPoints_.back();
+  pendingPoints_.assign(1, position);
+  return lastKeptPoint_;
+}
+
+//-----------------------------------------------------------------------------
+bool StreamingPathSimplifier::canSkipPendingPoints_(const Eigen::Vector2d & position) const
+{
+  if ((position - *lastKeptPoint_).norm() > maximalDistanceBetweenTwoPoints_) {
+    return false;
+  }
+
+  return std::all_of(
+    pendingPoints_.begin(), pendingPoints_.end(), [&](const Eigen::Vector2d & point) {
+      return distanceToSegment(point, *lastKeptPoint_, position) <= maximalLateralError_;
+    });
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<Eigen::Vector2d> & StreamingPathSimplifier::getPendingPoints() const
+{
+  return pendingPoints_;
+}
+
+//-----------------------------------------------------------------------------
+void StreamingPathSimplifier::reset()
+{
+  lastKeptPoint_.reset();
+  pendingPoints_.clear();
+}
+
+//-----------------------------------------------------------------------------
+void StreamingPathSimplifier::restore(
+  const Eigen::Vector2d & lastKeptPoint,
+  const std::vector<Eigen::Vector2d> & pendingPoints)
+{
+  lastKeptPoint_ = lastKeptPoint;
+  pendingPoints_ = pendingPoints;
+}
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,215 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <unistd.h>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+// romea
+#include "romea_core_path_matching/RingBuffer.hpp"
+#include "romea_core_path_matching/Tracing.hpp"
+
+namespace
+{
+
+struct ThreadTraceBuffer
+{
+  explicit ThreadTraceBuffer(const size_t & threadId)
+  : threadId(threadId),
+    events(),
+    droppedEventsCount(0),
+    finished(false)
+  {
+  }
+
+  size_t threadId;
+  romea::core::SpscRingBuffer<romea::core::TraceEvent,
+    romea::core::Tracer::THREAD_BUFFER_CAPACITY> events;
+  std::atomic<size_t> droppedEventsCount;
+  std::atomic<bool> finished;
+};
+
+// buffers are kept after their thread ends so its events can still be dumped, once
+// drained they are recycled by the next threads instead of being allocated again
+struct TraceRegistry
+{
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> recycledBuffers;
+  size_t numberOfThreads = 0;
+  size_t droppedEventsCountOfRecycledBuffers = 0;
+};
+
+TraceRegistry & traceRegistry()
+{
+  static TraceRegistry registry;
+  return registry;
+}
+
+// buffer is flagged as finished when its thread ends
+class ThreadTraceBufferHandle
+{
+public:
+  ThreadTraceBufferHandle()
+  : buffer_()
+  {
+    auto & registry = traceRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (registry.recycledBuffers.empty()) {
+      buffer_ = std::make_shared<ThreadTraceBuffer>(registry.numberOfThreads);
+    } else {
+      buffer_ = std::move(registry.recycledBuffers.back());
+      registry.recycledBuffers.pop_back();
+      buffer_->threadId = registry.numberOfThreads;
+      buffer_->finished.store(false, std::memory_order_relaxed);
+    }
+    ++registry.numberOfThreads;
+    registry.buffers.push_back(buffer_);
+  }
+
+  ThreadTraceBufferHandle(const ThreadTraceBufferHandle &) = delete;
+  ThreadTraceBufferHandle & operator=(const ThreadTraceBufferHandle &) = delete;
+
+  ~ThreadTraceBufferHandle()
+  {
+    buffer_->finished.store(true, std::memory_order_release);
+  }
+
+  ThreadTraceBuffer & get()
+  {
+    return *buffer_;
+  }
+
+private:
+  std::shared_ptr<ThreadTraceBuffer> buffer_;
+};
+
+ThreadTraceBuffer & threadTraceBuffer()
+{
+  thread_local ThreadTraceBufferHandle handle;
+  return handle.get();
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+void Tracer::record(const char * name, const int64_t & begin, const int64_t & end)
+{
+  ThreadTraceBuffer & buffer = threadTraceBuffer();
+  if (!buffer.events.push({name, begin, end - begin})) {
+    buffer.droppedEventsCount.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+//-----------------------------------------------------------------------------
+int64_t Tracer::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-----------------------------------------------------------------------------
+void Tracer::writeChromeTrace(std::ostream & os)
+{
+  nlohmann::json traceEvents = nlohmann::json::array();
+
+  {
+    auto & registry = traceRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const long processId = static_cast<long>(getpid());
+
+    TraceEvent event;
+    auto it = registry.buffers.begin();
+    while (it != registry.buffers.end()) {
+      // events pushed before the thread finished are all visible once the flag is read
+      const auto & buffer = *it;
+      const bool finished = buffer->finished.load(std::memory_order_acquire);
+      while (buffer->events.pop(event)) {
+        // chrome trace time unit is the microsecond
+        nlohmann::json traceEvent = nlohmann::json::object();
+        traceEvent["name"] = event.name;
+        traceEvent["cat"] = "romea_path_matching";
+        traceEvent["ph"] = "X";
+        traceEvent["ts"] = event.begin * 1e-3;
+        traceEvent["dur"] = event.duration * 1e-3;
+        traceEvent["pid"] = processId;
+        traceEvent["tid"] = buffer->threadId;
+        traceEvents.push_back(traceEvent);
+      }
+
+      if (finished) {
+        registry.droppedEventsCountOfRecycledBuffers +=
+          buffer->droppedEventsCount.exchange(0, std::memory_order_relaxed);
+        registry.recycledBuffers.push_back(std::move(*it));
+        it = registry.buffers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  nlohmann::json trace = nlohmann::json::object();
+  trace["traceEvents"] = traceEvents;
+  trace["displayTimeUnit"] = "ns";
+  os << trace.dump();
+}
+
+//-----------------------------------------------------------------------------
+void Tracer::writeChromeTrace(const std::string & filename)
+{
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Unable to open trace file " + filename);
+  }
+  writeChromeTrace(file);
+}
+
+//-----------------------------------------------------------------------------
+size_t Tracer::getDroppedEventsCount()
+{
+  auto & registry = traceRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  size_t droppedEventsCount = registry.droppedEventsCountOfRecycledBuffers;
+  for (const auto & buffer : registry.buffers) {
+    droppedEventsCount += buffer->droppedEventsCount.load(std::memory_order_relaxed);
+  }
+  return droppedEventsCount;
+}
+
+//-----------------------------------------------------------------------------
+size_t Tracer::getNumberOfThreadBuffers()
+{
+  auto & registry = traceRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.buffers.size() + registry.recycledBuffers.size();
+}
+
+}  // namespace core
+}  // namespace romea
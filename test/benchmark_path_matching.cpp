@@ -0,0 +1,439 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Performance regression gate of path matching. Each benchmark reports its median and
+// 99th percentile call latency and its number of allocations per call. Latencies are
+// normalised by a fixed calibration workload so baselines can be compared between
+// machines. Usage:
+//   benchmark [--baseline FILE] [--update-baseline] [--iterations N]
+//             [--latency-tolerance RATIO] [--allocation-tolerance RATIO]
+// With --update-baseline results are written to the baseline file, otherwise the run
+// fails when a normalised median latency or an allocation count exceeds its baseline
+// value by more than the tolerance, or when a benchmark has no baseline value so that
+// an unrecorded baseline never passes. Amortised allocation counts depend on the number
+// of iterations, so comparisons run as many iterations as the baseline unless told
+// otherwise.
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+// romea
+#include "../test/test_helper.h"
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+#include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+#include "romea_core_path_matching/PathMatching.hpp"
+
+namespace
+{
+std::atomic<size_t> numberOfAllocations(0);
+}  // namespace
+
+void * operator new(size_t size)
+{
+  numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * pointer = std::malloc(size > 0 ? size : 1)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void * pointer, size_t) noexcept
+{
+  std::free(pointer);
+}
+
+namespace
+{
+
+constexpr size_t DEFAULT_NUMBER_OF_ITERATIONS = 20000;
+
+struct Options
+{
+  std::string baseline = std::string(TEST_DIR) + "/benchmark_baseline.json";
+  bool updateBaseline = false;
+  size_t iterations = 0;
+  double latencyTolerance = 0.3;
+  double allocationTolerance = 0.0;
+};
+
+struct BenchmarkResult
+{
+  double medianLatency;
+  double percentile99Latency;
+  double allocationsPerCall;
+};
+
+int64_t now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double percentile(std::vector<double> values, const double & ratio)
+{
+  const size_t index = std::min(values.size() - 1, static_cast<size_t>(ratio * values.size()));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+// Median duration of a fixed arithmetic and memory workload
+double calibrate()
+{
+  std::vector<double> values(4096);
+  std::iota(values.begin(), values.end(), 1.);
+
+  std::vector<double> durations;
+  volatile double sink = 0;
+  for (size_t run = 0; run < 31; ++run) {
+    const int64_t start = now();
+    for (size_t k = 0; k < 64; ++k) {
+      for (auto & value : values) {
+        value = std::sqrt(value * value + 1.) * 0.999;
+      }
+    }
+    durations.push_back(static_cast<double>(now() - start));
+    sink = sink + values[run];
+  }
+  return percentile(durations, 0.5);
+}
+
+// step is called once per iteration, only calls made through measure are timed
+BenchmarkResult runBenchmark(
+  const size_t & iterations,
+  const std::function<void(size_t, const std::function<void(const std::function<void()> &)> &)> &
+  step)
+{
+  std::vector<double> latencies;
+  latencies.reserve(iterations);
+  size_t allocations = 0;
+
+  auto measure = [&](const std::function<void()> & call) {
+      const size_t firstAllocation = numberOfAllocations.load(std::memory_order_relaxed);
+      const int64_t start = now();
+      call();
+      latencies.push_back(static_cast<double>(now() - start));
+      allocations += numberOfAllocations.load(std::memory_order_relaxed) - firstAllocation;
+    };
+
+  for (size_t n = 0; n < iterations; ++n) {
+    step(n, measure);
+  }
+
+  return {percentile(latencies, 0.5), percentile(latencies, 0.99),
+    static_cast<double>(allocations) / latencies.size()};
+}
+
+romea::core::Pose2D poseOnPath(
+  const romea::core::PathSection2D & section,
+  const size_t & index,
+  const double & lateralDeviation)
+{
+  const auto & X = section.getX();
+  const auto & Y = section.getY();
+  const size_t i = std::min(index, X.size() - 2);
+
+  romea::core::Pose2D pose;
+  pose.yaw = std::atan2(Y[i + 1] - Y[i], X[i + 1] - X[i]);
+  pose.position.x() = X[i] - std::sin(pose.yaw) * lateralDeviation;
+  pose.position.y() = Y[i] + std::cos(pose.yaw) * lateralDeviation;
+  return pose;
+}
+
+// Field coverage path, swaths of 100 m linked by half turns
+std::vector<std::vector<romea::core::PathWayPoint2D>> makeSerpentineWayPoints()
+{
+  std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints;
+  for (size_t swath = 0; swath < 20; ++swath) {
+    std::vector<romea::core::PathWayPoint2D> section;
+    const double y = swath * 6.;
+    for (size_t n = 0; n <= 1000; ++n) {
+      const double x = swath % 2 == 0 ? n * 0.1 : 100 - n * 0.1;
+      section.emplace_back(Eigen::Vector2d(x, y), 2.0);
+    }
+    for (size_t n = 1; n < 94; ++n) {
+      const double angle = n * M_PI / 94;
+      const double x = swath % 2 == 0 ? 100 + 3 * std::sin(angle) : -3 * std::sin(angle);
+      section.emplace_back(Eigen::Vector2d(x, y + 3 - 3 * std::cos(angle)), 2.0);
+    }
+    wayPoints.push_back(section);
+  }
+  return wayPoints;
+}
+
+romea::core::PathMatching makePathMatching()
+{
+  return romea::core::PathMatching(
+    std::string(TEST_DIR) + "/test_path_matching.cvs",
+    romea::core::makeGeodeticCoordinates(45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3),
+    10.0, 3.0);
+}
+
+BenchmarkResult benchmarkPathMatchingOnTestPath(const size_t & iterations)
+{
+  romea::core::PathMatching pathMatching = makePathMatching();
+  const auto & section = pathMatching.getPath().getSection(0);
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+
+  // follower goes back and forth along the path
+  const size_t size = section.size() - 1;
+  return runBenchmark(
+    iterations, [&](const size_t & n, const auto & measure) {
+      const size_t cycle = n % (2 * size);
+      const size_t index = cycle < size ? cycle : 2 * size - cycle;
+      twist.linearSpeeds.x() = cycle < size ? 2.0 : -2.0;
+      auto pose = poseOnPath(section, index, 0.3);
+      measure(
+        [&]() {
+          pathMatching.match(romea::core::durationFromSecond(n * 0.1), pose, twist, 0.5);
+        });
+    });
+}
+
+BenchmarkResult benchmarkPathMatchingOnSerpentine(const size_t & iterations)
+{
+  romea::core::PathMatching pathMatching = makePathMatching();
+  pathMatching.setPath(romea::core::Path2D(makeSerpentineWayPoints(), 3.0));
+  const auto & path = pathMatching.getPath();
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+
+  size_t sectionIndex = 0;
+  size_t index = 0;
+  return runBenchmark(
+    iterations, [&](const size_t & n, const auto & measure) {
+      if (++index + 1 >= path.getSection(sectionIndex).size()) {
+        sectionIndex = (sectionIndex + 1) % path.size();
+        index = 0;
+      }
+      auto pose = poseOnPath(path.getSection(sectionIndex), index, 0.3);
+      measure(
+        [&]() {
+          pathMatching.match(romea::core::durationFromSecond(n * 0.1), pose, twist, 0.5);
+        });
+    });
+}
+
+// Relocalisation on the serpentine joined into a single section of about 22 000 way points
+BenchmarkResult benchmarkCoarseToFineOnSingleSection(const size_t & iterations)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (const auto & section : makeSerpentineWayPoints()) {
+    wayPoints.insert(wayPoints.end(), section.begin(), section.end());
+  }
+  const romea::core::Path2D path({wayPoints}, 3.0);
+  const romea::core::CoarsePathIndex pathIndex(path);
+  const auto & section = path.getSection(0);
+
+  return runBenchmark(
+    iterations, [&](const size_t & n, const auto & measure) {
+      auto pose = poseOnPath(section, (n * 7919) % section.size(), 0.3);
+      measure(
+        [&]() {
+          romea::core::matchCoarseToFine(path, pathIndex, pose, 2.0, 0.5, 10.0);
+        });
+    });
+}
+
+// Leader drives a wide circle, the follower stays 20 m behind
+romea::core::Pose2D leaderPose(const size_t & n)
+{
+  const double angle = n * 0.2 / 200.;
+  romea::core::Pose2D pose;
+  pose.position.x() = 200 * std::sin(angle);
+  pose.position.y() = 200 * (1 - std::cos(angle));
+  pose.yaw = angle;
+  return pose;
+}
+
+BenchmarkResult benchmarkOnTheFlyUpdatePath(const size_t & iterations)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+
+  return runBenchmark(
+    iterations, [&](const size_t & n, const auto & measure) {
+      auto pose = leaderPose(n);
+      measure(
+        [&]() {
+          pathMatching.updatePath(romea::core::durationFromSecond(n * 0.1), pose, twist);
+        });
+    });
+}
+
+BenchmarkResult benchmarkOnTheFlyMatch(const size_t & iterations)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+
+  for (size_t n = 0; n < 100; ++n) {
+    pathMatching.updatePath(romea::core::durationFromSecond(n * 0.1), leaderPose(n), twist);
+  }
+
+  return runBenchmark(
+    iterations, [&](const size_t & n, const auto & measure) {
+      const auto stamp = romea::core::durationFromSecond((n + 100) * 0.1);
+      pathMatching.updatePath(stamp, leaderPose(n + 100), twist);
+      auto pose = leaderPose(n);
+      measure([&]() {pathMatching.match(stamp, pose, twist);});
+    });
+}
+
+nlohmann::json toJson(const BenchmarkResult & result, const double & calibration)
+{
+  nlohmann::json json = nlohmann::json::object();
+  json["median_latency_ns"] = result.medianLatency;
+  json["percentile99_latency_ns"] = result.percentile99Latency;
+  json["normalised_median_latency"] = result.medianLatency / calibration;
+  json["allocations_per_call"] = result.allocationsPerCall;
+  return json;
+}
+
+bool parseOptions(int argc, char ** argv, Options & options)
+{
+  for (int n = 1; n < argc; ++n) {
+    const std::string argument = argv[n];
+    const bool hasValue = n + 1 < argc;
+    if (argument == "--update-baseline") {
+      options.updateBaseline = true;
+    } else if (argument == "--baseline" && hasValue) {
+      options.baseline = argv[++n];
+    } else if (argument == "--iterations" && hasValue) {
+      options.iterations = std::stoul(argv[++n]);
+    } else if (argument == "--latency-tolerance" && hasValue) {
+      options.latencyTolerance = std::stod(argv[++n]);
+    } else if (argument == "--allocation-tolerance" && hasValue) {
+      options.allocationTolerance = std::stod(argv[++n]);
+    } else {
+      std::cerr << "Unknown or incomplete option " << argument << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Return the number of regressions, benchmarks missing from baseline count as ones
+size_t compare(
+  const nlohmann::json & results,
+  const nlohmann::json & baseline,
+  const Options & options)
+{
+  size_t numberOfRegressions = 0;
+  for (const auto & [name, result] : results["benchmarks"].items()) {
+    if (!baseline["benchmarks"].contains(name)) {
+      std::cout << name << ": no baseline, record it with --update-baseline" << std::endl;
+      ++numberOfRegressions;
+      continue;
+    }
+    const auto & reference = baseline["benchmarks"][name];
+
+    const double latencyRatio = result["normalised_median_latency"].get<double>() /
+      reference["normalised_median_latency"].get<double>();
+    const double allocations = result["allocations_per_call"].get<double>();
+    const double referenceAllocations = reference["allocations_per_call"].get<double>();
+
+    const bool latencyRegression = latencyRatio > 1 + options.latencyTolerance;
+    const bool allocationRegression =
+      allocations > referenceAllocations * (1 + options.allocationTolerance) + 1e-6;
+
+    std::cout << name << ": latency x" << latencyRatio <<
+      (latencyRegression ? " REGRESSION" : "") << ", allocations per call " << allocations <<
+      " (baseline " << referenceAllocations << ")" <<
+      (allocationRegression ? " REGRESSION" : "") << std::endl;
+    numberOfRegressions += latencyRegression + allocationRegression;
+  }
+  return numberOfRegressions;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    return 2;
+  }
+
+  nlohmann::json baseline;
+  if (!options.updateBaseline) {
+    std::ifstream file(options.baseline);
+    if (!file.is_open()) {
+      std::cerr << "Unable to read baseline " << options.baseline <<
+        ", run with --update-baseline to record it" << std::endl;
+      return 2;
+    }
+    baseline = nlohmann::json::parse(file);
+    if (options.iterations == 0) {
+      options.iterations = baseline["iterations"].get<size_t>();
+    }
+  }
+
+  if (options.iterations == 0) {
+    options.iterations = DEFAULT_NUMBER_OF_ITERATIONS;
+  }
+
+  const double calibration = calibrate();
+  nlohmann::json results = nlohmann::json::object();
+  results["calibration_ns"] = calibration;
+  results["iterations"] = options.iterations;
+
+  nlohmann::json benchmarks = nlohmann::json::object();
+  benchmarks["path_matching_match_test_path"] =
+    toJson(benchmarkPathMatchingOnTestPath(options.iterations), calibration);
+  benchmarks["path_matching_match_serpentine"] =
+    toJson(benchmarkPathMatchingOnSerpentine(options.iterations), calibration);
+  benchmarks["coarse_to_fine_single_section"] =
+    toJson(benchmarkCoarseToFineOnSingleSection(options.iterations), calibration);
+  benchmarks["on_the_fly_path_matching_update_path"] =
+    toJson(benchmarkOnTheFlyUpdatePath(options.iterations), calibration);
+  benchmarks["on_the_fly_path_matching_match"] =
+    toJson(benchmarkOnTheFlyMatch(options.iterations), calibration);
+  results["benchmarks"] = benchmarks;
+
+  std::cout << results.dump(2) << std::endl;
+
+  if (options.updateBaseline) {
+    std::ofstream file(options.baseline);
+    if (!file.is_open()) {
+      std::cerr << "Unable to write baseline " << options.baseline << std::endl;
+      return 2;
+    }
+    file << results.dump(2) << std::endl;
+    return 0;
+  }
+
+  return compare(results, baseline, options) == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/CoarsePathIndex.hpp"
+
+namespace
+{
+// parallel swaths of 100 m spaced by 5 m, one section per swath
+romea::core::Path2D makeSwathsPath(const size_t & numberOfSwaths)
+{
+  std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints(numberOfSwaths);
+  for (size_t s = 0; s < numberOfSwaths; ++s) {
+    for (size_t n = 0; n <= 1000; ++n) {
+      double x = s % 2 == 0 ? n * 0.1 : 100 - n * 0.1;
+      wayPoints[s].emplace_back(Eigen::Vector2d(x, s * 5.0));
+    }
+  }
+  return romea::core::Path2D(wayPoints, 3.0);
+}
+
+// same swaths joined by half turns into a single section
+romea::core::Path2D makeSingleSectionSwathsPath(const size_t & numberOfSwaths)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t s = 0; s < numberOfSwaths; ++s) {
+    for (size_t n = 0; n <= 1000; ++n) {
+      double x = s % 2 == 0 ? n * 0.1 : 100 - n * 0.1;
+      wayPoints.emplace_back(Eigen::Vector2d(x, s * 5.0));
+    }
+    for (size_t n = 1; n < 25; ++n) {
+      double angle = n * M_PI / 25;
+      double x = s % 2 == 0 ? 100 + 2.5 * std::sin(angle) : -2.5 * std::sin(angle);
+      wayPoints.emplace_back(Eigen::Vector2d(x, s * 5.0 + 2.5 * (1 - std::cos(angle))));
+    }
+  }
+  return romea::core::Path2D({wayPoints}, 3.0);
+}
+
+void expectSameMatchedPoints(
+  const std::vector<romea::core::PathMatchedPoint2D> & matchedPoints,
+  const std::vector<romea::core::PathMatchedPoint2D> & expected)
+{
+  ASSERT_EQ(matchedPoints.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(matchedPoints[i].sectionIndex, expected[i].sectionIndex);
+    EXPECT_DOUBLE_EQ(
+      matchedPoints[i].frenetPose.curvilinearAbscissa,
+      expected[i].frenetPose.curvilinearAbscissa);
+    EXPECT_DOUBLE_EQ(
+      matchedPoints[i].frenetPose.lateralDeviation,
+      expected[i].frenetPose.lateralDeviation);
+  }
+}
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestCoarsePathIndex, testCandidateSections)
+{
+  auto path = makeSwathsPath(10);
+  romea::core::CoarsePathIndex index(path);
+  EXPECT_EQ(index.size(), 10);
+
+  auto sections = index.findCandidateSections(Eigen::Vector2d(50, 11), 5);
+  ASSERT_EQ(sections.size(), 2);
+  EXPECT_EQ(sections[0], 2);
+  EXPECT_EQ(sections[1], 3);
+
+  EXPECT_TRUE(index.findCandidateSections(Eigen::Vector2d(200, 11), 3).empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestCoarsePathIndex, testCandidateChunks)
+{
+  auto path = makeSwathsPath(1);
+  romea::core::CoarsePathIndex index(path, 11);
+
+  std::vector<std::pair<size_t, size_t>> chunks;
+  index.findCandidateChunks(0, Eigen::Vector2d(50, 0.5), 0.6, chunks);
+  ASSERT_FALSE(chunks.empty());
+  for (const auto & chunk : chunks) {
+    EXPECT_LE(chunk.first, 500);
+    EXPECT_GE(chunk.second, 500);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestCoarsePathIndex, testSameResultsThanExhaustiveResearch)
+{
+  auto path = makeSwathsPath(20);
+  romea::core::CoarsePathIndex index(path);
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> xDistribution(-20, 120);
+  std::uniform_real_distribution<double> yDistribution(-20, 115);
+
+  for (size_t n = 0; n < 200; ++n) {
+    romea::core::Pose2D pose;
+    pose.position = Eigen::Vector2d(xDistribution(generator), yDistribution(generator));
+
+    auto expected = romea::core::match(path, pose, 1.0, 0.0, 10.0);
+    auto matchedPoints = romea::core::matchCoarseToFine(path, index, pose, 1.0, 0.0, 10.0);
+    expectSameMatchedPoints(matchedPoints, expected);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestCoarsePathIndex, testLargeSingleSection)
+{
+  // about 100 000 way points in one section
+  auto path = makeSingleSectionSwathsPath(100);
+  romea::core::CoarsePathIndex index(path);
+  ASSERT_EQ(index.size(), 1u);
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> xDistribution(-5, 105);
+  std::uniform_real_distribution<double> yDistribution(-5, 500);
+
+  std::vector<romea::core::Pose2D> poses(200);
+  for (auto & pose : poses) {
+    pose.position = Eigen::Vector2d(xDistribution(generator), yDistribution(generator));
+    auto expected = romea::core::match(path, pose, 1.0, 0.0, 2.0);
+    auto matchedPoints = romea::core::matchCoarseToFine(path, index, pose, 1.0, 0.0, 2.0);
+    expectSameMatchedPoints(matchedPoints, expected);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto & pose : poses) {
+    romea::core::matchCoarseToFine(path, index, pose, 1.0, 0.0, 2.0);
+  }
+  auto duration = std::chrono::steady_clock::now() - start;
+
+#ifndef ROMEA_PATH_MATCHING_SANITIZERS
+  // relocalisation cost depends on the research radius, not on section length
+  EXPECT_LT(duration / poses.size(), std::chrono::milliseconds(1));
+#endif
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <string>
+#include <thread>
+
+// romea
+#include "romea_core_path_matching/DeferredOnTheFlyPathMatchingDiagnostic.hpp"
+
+bool boolean(const romea::core::DiagnosticStatus & status)
+{
+  return status == romea::core::DiagnosticStatus::OK;
+}
+
+
+class TestDeferredOnTheFlyPathMatchingDiagnostic : public ::testing::Test
+{
+public:
+  TestDeferredOnTheFlyPathMatchingDiagnostic()
+  {
+  }
+
+  romea::core::DiagnosticReport getReport(
+    const bool & leaderLocalisationStatus,
+    const bool & followerLocalisationStatus,
+    const bool & pathMatchingStatus,
+    const double & stamp)
+  {
+    if (followerLocalisationStatus) {
+      for (size_t n = 0; n <= 10; ++n) {
+        diagnostic.updateFollowerLocalisationRate(romea::core::durationFromSecond(n * 0.1));
+      }
+    }
+
+    if (leaderLocalisationStatus) {
+      for (size_t n = 0; n <= 10; ++n) {
+        diagnostic.updateLeaderLocalisationRate(romea::core::durationFromSecond(n * 0.1));
+      }
+    }
+
+    if (leaderLocalisationStatus && followerLocalisationStatus) {
+      diagnostic.updatePathMatchingStatus(pathMatchingStatus);
+    }
+
+    return diagnostic.makeReport(romea::core::durationFromSecond(stamp));
+  }
+
+  romea::core::DeferredOnTheFlyPathMatchingDiagnostic diagnostic;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestDeferredOnTheFlyPathMatchingDiagnostic, testInitialValue)
+{
+  auto report = getReport(false, false, false, 1.0);
+  EXPECT_EQ(report.diagnostics.size(), 2);
+  EXPECT_STREQ(
+    report.diagnostics.front().message.c_str(), "no data received from leader_localisation");
+  EXPECT_STREQ(
+    report.diagnostics.back().message.c_str(), "no data received from follower_localisation");
+  EXPECT_STREQ(report.info["path_matching"].c_str(), "");
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestDeferredOnTheFlyPathMatchingDiagnostic, testPathMatchingSucceded)
+{
+  auto report = getReport(true, true, true, 1.0);
+  EXPECT_EQ(report.diagnostics.size(), 3);
+  EXPECT_STREQ(
+    report.diagnostics.front().message.c_str(), "leader_localisation_rate is OK.");
+  EXPECT_EQ(boolean(report.diagnostics.back().status), true);
+  EXPECT_STREQ(report.diagnostics.back().message.c_str(), "path matching succeeded.");
+  EXPECT_STREQ(report.info["leader_localisation_rate"].c_str(), "10");
+  EXPECT_STREQ(report.info["follower_localisation_rate"].c_str(), "10");
+  EXPECT_STREQ(report.info["path_matching"].c_str(), "true");
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestDeferredOnTheFlyPathMatchingDiagnostic, testPathMatchingFailed)
+{
+  auto report = getReport(true, true, false, 1.0);
+  EXPECT_EQ(boolean(report.diagnostics.back().status), false);
+  EXPECT_STREQ(report.diagnostics.back().message.c_str(), "path matching failed.");
+  EXPECT_STREQ(report.info["path_matching"].c_str(), "false");
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestDeferredOnTheFlyPathMatchingDiagnostic, testReportFromAnotherThread)
+{
+  std::thread leader([this]() {
+      for (size_t n = 0; n < 100000; ++n) {
+        diagnostic.updateLeaderLocalisationRate(romea::core::durationFromSecond(n * 0.01));
+      }
+    });
+
+  std::thread follower([this]() {
+      for (size_t n = 0; n < 100000; ++n) {
+        diagnostic.updateFollowerLocalisationRate(romea::core::durationFromSecond(n * 0.01));
+        diagnostic.updatePathMatchingStatus(n % 2 == 0);
+      }
+    });
+
+  for (size_t n = 0; n < 1000; ++n) {
+    diagnostic.makeReport(romea::core::durationFromSecond(n));
+  }
+  leader.join();
+  follower.join();
+
+  auto report = getReport(true, true, false, 1.0);
+  EXPECT_STREQ(report.info["path_matching"].c_str(), "false");
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,101 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// romea
+#include "romea_core_path_matching/LeaderTimeline.hpp"
+#include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTimeline, testLookup)
+{
+  romea::core::LeaderTimeline timeline;
+  EXPECT_FALSE(timeline.getStamp(0).has_value());
+
+  // leader accelerates from 1 m/s to 2 m/s
+  timeline.append(0.0, romea::core::durationFromSecond(10.0), 1.0);
+  timeline.append(1.0, romea::core::durationFromSecond(11.0), 1.0);
+  timeline.append(3.0, romea::core::durationFromSecond(12.0), 2.0);
+  EXPECT_EQ(timeline.size(), 3);
+
+  EXPECT_NEAR(romea::core::durationToSecond(*timeline.getStamp(2.0)), 11.5, 1e-9);
+  EXPECT_NEAR(*timeline.getSpeed(2.0), 1.5, 1e-6);
+  EXPECT_NEAR(*timeline.getCurvilinearAbscissa(romea::core::durationFromSecond(10.5)), 0.5, 1e-9);
+  EXPECT_NEAR(*timeline.getCurvilinearAbscissa(romea::core::durationFromSecond(12.0)), 3.0, 1e-9);
+
+  EXPECT_FALSE(timeline.getStamp(-1.0).has_value());
+  EXPECT_FALSE(timeline.getSpeed(3.5).has_value());
+  EXPECT_FALSE(timeline.getCurvilinearAbscissa(romea::core::durationFromSecond(9.0)).has_value());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTimeline, testEraseFrontAndPrepend)
+{
+  romea::core::LeaderTimeline timeline;
+  for (size_t i = 0; i < 5; ++i) {
+    timeline.append(i, romea::core::durationFromSecond(i), 1.0);
+  }
+
+  timeline.eraseFront(2);
+  EXPECT_EQ(timeline.size(), 3);
+  EXPECT_FALSE(timeline.getStamp(1.0).has_value());
+  EXPECT_NEAR(romea::core::durationToSecond(*timeline.getStamp(2.5)), 2.5, 1e-9);
+
+  romea::core::LeaderTimeline olderTimeline;
+  olderTimeline.append(0.0, romea::core::durationFromSecond(0), 1.0);
+  olderTimeline.append(1.0, romea::core::durationFromSecond(1), 1.0);
+  timeline.prepend(olderTimeline);
+  EXPECT_EQ(timeline.size(), 5);
+  EXPECT_NEAR(romea::core::durationToSecond(*timeline.getStamp(1.5)), 1.5, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTimeline, testOnTheFlyPathMatching)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+
+  double dt = 0.1;
+  romea::core::Twist2D leader_twist;
+  leader_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D leader_pose;
+  for (size_t i = 0; i < 100; ++i) {
+    pathMatching.updatePath(romea::core::durationFromSecond(i * dt), leader_pose, leader_twist);
+    leader_pose.position.x() += leader_twist.linearSpeeds.x() * dt;
+  }
+
+  const auto & timeline = pathMatching.getLeaderTimeline();
+  ASSERT_GT(timeline.size(), 2);
+
+  // leader drove at 2 m/s, it was at x=10 five seconds after its first way point
+  auto firstStamp = romea::core::Duration(timeline.getStamps().front());
+  auto abscissa = pathMatching.getLeaderCurvilinearAbscissa(
+    firstStamp + romea::core::durationFromSecond(5.0));
+  ASSERT_TRUE(abscissa.has_value());
+  EXPECT_NEAR(*abscissa, 10.0, 1e-6);
+
+  romea::core::PathMatchedPoint2D matchedPoint;
+  matchedPoint.frenetPose.curvilinearAbscissa = 10.0;
+  EXPECT_NEAR(*pathMatching.getLeaderSpeed(matchedPoint), 2.0, 1e-6);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,218 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cmath>
+#include <random>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/LeaderTrailArchive.hpp"
+
+namespace
+{
+
+void makeTrail(
+  const size_t & size,
+  const double & firstX,
+  std::vector<romea::core::LeaderSample> & leaderSamples,
+  std::vector<double> & curvilinearAbscissas)
+{
+  std::mt19937 generator(size);
+  std::uniform_real_distribution<double> uniform(-0.05, 0.05);
+
+  leaderSamples.clear();
+  curvilinearAbscissas.clear();
+  Eigen::Vector2d position(firstX, 0);
+  double curvilinearAbscissa = firstX;
+  for (size_t n = 0; n < size; ++n) {
+    leaderSamples.push_back(
+      {position, romea::core::durationFromSecond(firstX + n * 0.1), 2.0 + uniform(generator)});
+    curvilinearAbscissas.push_back(curvilinearAbscissa);
+
+    Eigen::Vector2d step(0.2 + uniform(generator), uniform(generator));
+    position += step;
+    curvilinearAbscissa += step.norm();
+  }
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTrailArchive, testDecodedSamplesAreWithinQuantizationBounds)
+{
+  std::vector<romea::core::LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  makeTrail(1000, 0., leaderSamples, curvilinearAbscissas);
+
+  romea::core::LeaderTrailArchive archive;
+  archive.archive(
+    {leaderSamples.begin(), leaderSamples.begin() + 400},
+    {curvilinearAbscissas.begin(), curvilinearAbscissas.begin() + 400});
+  archive.archive(
+    {leaderSamples.begin() + 400, leaderSamples.end()},
+    {curvilinearAbscissas.begin() + 400, curvilinearAbscissas.end()});
+  EXPECT_EQ(archive.size(), 1000u);
+
+  std::vector<romea::core::LeaderSample> decodedLeaderSamples;
+  std::vector<double> decodedCurvilinearAbscissas;
+  archive.decode(decodedLeaderSamples, decodedCurvilinearAbscissas);
+  ASSERT_EQ(decodedLeaderSamples.size(), 1000u);
+  ASSERT_EQ(decodedCurvilinearAbscissas.size(), 1000u);
+
+  for (size_t n = 0; n < 1000; ++n) {
+    const auto & original = leaderSamples[n];
+    const auto & decoded = decodedLeaderSamples[n];
+    EXPECT_LE((decoded.position - original.position).cwiseAbs().maxCoeff(), 0.0005 + 1e-9);
+    EXPECT_LE(decoded.stamp.count(), original.stamp.count());
+    EXPECT_GT(decoded.stamp.count(), original.stamp.count() - 1000);
+    EXPECT_NEAR(decoded.speed, original.speed, 0.001);
+    EXPECT_LE(decodedCurvilinearAbscissas[n], curvilinearAbscissas[n] + 1e-9);
+    EXPECT_GT(decodedCurvilinearAbscissas[n], curvilinearAbscissas[n] - 0.001);
+  }
+
+  // original samples take 40 bytes in path section and leader timeline
+  EXPECT_LT(archive.getMemoryUsage(), 1000 * 16);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTrailArchive, testLargeDeltasSplitChunks)
+{
+  std::vector<romea::core::LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  makeTrail(100, 0., leaderSamples, curvilinearAbscissas);
+
+  // leader localisation jumps and leader stays stopped for two hours
+  for (size_t n = 50; n < 100; ++n) {
+    leaderSamples[n].position.x() += 100.;
+    curvilinearAbscissas[n] += 100.;
+  }
+  for (size_t n = 75; n < 100; ++n) {
+    leaderSamples[n].stamp += romea::core::durationFromSecond(7200.);
+  }
+
+  romea::core::LeaderTrailArchive archive;
+  archive.archive(leaderSamples, curvilinearAbscissas);
+
+  std::vector<romea::core::LeaderSample> decodedLeaderSamples;
+  std::vector<double> decodedCurvilinearAbscissas;
+  archive.decode(decodedLeaderSamples, decodedCurvilinearAbscissas);
+  ASSERT_EQ(decodedLeaderSamples.size(), 100u);
+  for (size_t n = 0; n < 100; ++n) {
+    EXPECT_NEAR(decodedLeaderSamples[n].position.x(), leaderSamples[n].position.x(), 0.0005);
+    EXPECT_NEAR(decodedCurvilinearAbscissas[n], curvilinearAbscissas[n], 0.001);
+    EXPECT_NEAR(
+      decodedLeaderSamples[n].stamp.count(), leaderSamples[n].stamp.count(), 1000);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTrailArchive, testRestoreFromNewestReachedChunk)
+{
+  romea::core::LeaderTrailArchive archive;
+  std::vector<romea::core::LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  for (size_t n = 0; n < 3; ++n) {
+    makeTrail(500, n * 100., leaderSamples, curvilinearAbscissas);
+    archive.archive(leaderSamples, curvilinearAbscissas);
+  }
+  EXPECT_EQ(archive.size(), 1500u);
+
+  EXPECT_FALSE(archive.restore({150., 50.}, 5., leaderSamples, curvilinearAbscissas));
+  EXPECT_TRUE(leaderSamples.empty());
+  EXPECT_EQ(archive.size(), 1500u);
+
+  ASSERT_TRUE(archive.restore({150., 2.}, 5., leaderSamples, curvilinearAbscissas));
+  ASSERT_EQ(leaderSamples.size(), 1000u);
+  EXPECT_NEAR(leaderSamples.front().position.x(), 100., 1e-9);
+  EXPECT_NEAR(curvilinearAbscissas.front(), 100., 1e-9);
+  EXPECT_EQ(archive.size(), 500u);
+
+  archive.clear();
+  EXPECT_TRUE(archive.empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTrailArchive, testMemoryUsageStaysUnderMaximalValueOnLongTrail)
+{
+  const size_t maximalMemoryUsage = 64 * 1024;
+  romea::core::LeaderTrailArchive archive(maximalMemoryUsage);
+
+  // about 40 km of trail, 2.4 MB once compressed without decimation
+  std::vector<romea::core::LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  for (size_t n = 0; n < 200; ++n) {
+    makeTrail(1000, n * 250., leaderSamples, curvilinearAbscissas);
+    archive.archive(leaderSamples, curvilinearAbscissas);
+    ASSERT_LE(archive.getMemoryUsage(), maximalMemoryUsage);
+  }
+  EXPECT_LT(archive.size(), 200000u);
+
+  std::vector<romea::core::LeaderSample> decodedLeaderSamples;
+  std::vector<double> decodedCurvilinearAbscissas;
+  archive.decode(decodedLeaderSamples, decodedCurvilinearAbscissas);
+  ASSERT_EQ(decodedLeaderSamples.size(), archive.size());
+  for (size_t n = 1; n < decodedCurvilinearAbscissas.size(); ++n) {
+    EXPECT_LE(decodedCurvilinearAbscissas[n - 1], decodedCurvilinearAbscissas[n]);
+    EXPECT_LE(decodedLeaderSamples[n - 1].stamp, decodedLeaderSamples[n].stamp);
+  }
+
+  // newest chunk is still at full resolution and its last sample is kept
+  EXPECT_NEAR(
+    (decodedLeaderSamples.back().position - leaderSamples.back().position).norm(), 0., 0.001);
+  EXPECT_NEAR(decodedCurvilinearAbscissas.back(), curvilinearAbscissas.back(), 0.001);
+  EXPECT_GE(decodedLeaderSamples.size(), 1000u);
+  for (size_t n = 1; n <= 1000; ++n) {
+    EXPECT_NEAR(
+      decodedCurvilinearAbscissas[decodedCurvilinearAbscissas.size() - n],
+      curvilinearAbscissas[curvilinearAbscissas.size() - n], 0.001);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestLeaderTrailArchive, testOldestChunksAreDecimatedFirst)
+{
+  std::vector<romea::core::LeaderSample> leaderSamples;
+  std::vector<double> curvilinearAbscissas;
+  romea::core::LeaderTrailArchive archive;
+  for (size_t n = 0; n < 4; ++n) {
+    makeTrail(1000, n * 250., leaderSamples, curvilinearAbscissas);
+    archive.archive(leaderSamples, curvilinearAbscissas);
+  }
+  EXPECT_EQ(archive.size(), 4000u);
+
+  archive.setMaximalMemoryUsage(archive.getMemoryUsage() - 1);
+  EXPECT_LT(archive.size(), 4000u);
+  EXPECT_LE(archive.getMemoryUsage(), archive.getMaximalMemoryUsage());
+
+  std::vector<romea::core::LeaderSample> decodedLeaderSamples;
+  std::vector<double> decodedCurvilinearAbscissas;
+  archive.decode(decodedLeaderSamples, decodedCurvilinearAbscissas);
+
+  // only the first chunk lost samples, its first and last ones are kept
+  const size_t numberOfOldestSamples = archive.size() - 3000;
+  EXPECT_EQ(numberOfOldestSamples, 501u);
+  EXPECT_NEAR(decodedCurvilinearAbscissas.front(), 0., 1e-9);
+  EXPECT_NEAR(decodedLeaderSamples[numberOfOldestSamples].position.x(), 250., 1e-9);
+  makeTrail(1000, 0., leaderSamples, curvilinearAbscissas);
+  EXPECT_NEAR(
+    decodedCurvilinearAbscissas[numberOfOldestSamples - 1], curvilinearAbscissas.back(), 0.001);
+  EXPECT_NEAR(
+    decodedLeaderSamples[numberOfOldestSamples - 1].position.x(),
+    leaderSamples.back().position.x(), 0.001);
+}
@@ -0,0 +1,274 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/LeaderTrailJournal.hpp"
+#include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+
+class TestLeaderTrailJournal : public ::testing::Test
+{
+public:
+  TestLeaderTrailJournal()
+  : filename((std::filesystem::temp_directory_path() / "romea_leader_trail.journal").string())
+  {
+    std::filesystem::remove(filename);
+  }
+
+  ~TestLeaderTrailJournal() override
+  {
+    std::filesystem::remove(filename);
+  }
+
+  void drive(romea::core::OnTheFlyPathMatching & pathMatching, const size_t & numberOfSteps)
+  {
+    double dt = 0.1;
+    romea::core::Twist2D leader_twist;
+    leader_twist.linearSpeeds.x() = 2.0;
+
+    for (size_t i = 0; i < numberOfSteps; ++i, ++step) {
+      romea::core::Pose2D leader_pose;
+      leader_pose.position.x() = step * leader_twist.linearSpeeds.x() * dt;
+      pathMatching.updatePath(romea::core::durationFromSecond(step * dt), leader_pose, leader_twist);
+    }
+  }
+
+  std::optional<romea::core::PathMatchedPoint2D> match(
+    romea::core::OnTheFlyPathMatching & pathMatching)
+  {
+    romea::core::Twist2D follower_twist;
+    follower_twist.linearSpeeds.x() = 2.0;
+
+    romea::core::Pose2D follower_pose;
+    follower_pose.position.x() = 10;
+    follower_pose.position.y() = 1;
+
+    return pathMatching.match(romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  }
+
+  std::string filename;
+  size_t step = 0;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testRestoreAfterRestart)
+{
+  size_t numberOfWayPoints;
+  {
+    romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+    pathMatching.enableJournal(filename);
+    drive(pathMatching, 100);
+    numberOfWayPoints = pathMatching.getLeaderTimeline().size();
+  }
+
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  pathMatching.enableJournal(filename);
+  EXPECT_EQ(pathMatching.getLeaderTimeline().size(), numberOfWayPoints);
+  EXPECT_TRUE(match(pathMatching).has_value());
+
+  drive(pathMatching, 10);
+  EXPECT_EQ(
+    romea::core::LeaderTrailJournal::read(filename).size(),
+    pathMatching.getLeaderTimeline().size());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testTornRecordIsIgnored)
+{
+  romea::core::LeaderTrailJournal journal(filename);
+  for (size_t n = 0; n < 10; ++n) {
+    journal.append({Eigen::Vector2d(n, 0), romea::core::durationFromSecond(n), 1.0});
+  }
+
+  {
+    std::ofstream file(filename, std::ios::binary | std::ios::app);
+    file.write("torn", 4);
+  }
+
+  auto leaderSamples = romea::core::LeaderTrailJournal::read(filename);
+  ASSERT_EQ(leaderSamples.size(), 10);
+  EXPECT_DOUBLE_EQ(leaderSamples.back().position.x(), 9);
+  EXPECT_EQ(leaderSamples.back().stamp, romea::core::durationFromSecond(9));
+  EXPECT_DOUBLE_EQ(leaderSamples.back().speed, 1.0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testSnapshot)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  drive(pathMatching, 100);
+  pathMatching.writeSnapshot(filename);
+
+  romea::core::OnTheFlyPathMatching restoredPathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  restoredPathMatching.enableJournal(filename);
+  EXPECT_EQ(
+    restoredPathMatching.getLeaderTimeline().getStamps(),
+    pathMatching.getLeaderTimeline().getStamps());
+  EXPECT_EQ(
+    restoredPathMatching.getLeaderTimeline().getCurvilinearAbscissas(),
+    pathMatching.getLeaderTimeline().getCurvilinearAbscissas());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testSnapshotRestoresMatchingState)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  pathMatching.enableChangeDetection({0.1, 0.1, 0.1, 0.1});
+  drive(pathMatching, 100);
+  for (size_t n = 0; n < 5; ++n) {
+    ASSERT_TRUE(match(pathMatching).has_value());
+  }
+  ASSERT_GT(pathMatching.getNumberOfSkippedResearches(), 0u);
+  pathMatching.writeSnapshot(filename);
+
+  romea::core::OnTheFlyPathMatching restoredPathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  restoredPathMatching.enableJournal(filename);
+  EXPECT_EQ(
+    restoredPathMatching.getNumberOfSkippedResearches(),
+    pathMatching.getNumberOfSkippedResearches());
+
+  auto matchedPoint = match(pathMatching);
+  auto restoredMatchedPoint = match(restoredPathMatching);
+  ASSERT_TRUE(matchedPoint.has_value());
+  ASSERT_TRUE(restoredMatchedPoint.has_value());
+  EXPECT_NEAR(
+    restoredMatchedPoint->frenetPose.curvilinearAbscissa,
+    matchedPoint->frenetPose.curvilinearAbscissa, 1e-6);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testSnapshotOverEnabledJournal)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  pathMatching.enableJournal(filename);
+  drive(pathMatching, 50);
+  pathMatching.writeSnapshot(filename);
+
+  // way points inserted after the snapshot are logged in the new file
+  drive(pathMatching, 50);
+  EXPECT_EQ(
+    romea::core::LeaderTrailJournal::read(filename).size(),
+    pathMatching.getLeaderTimeline().size());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testMatchingStateIsLogged)
+{
+  std::optional<romea::core::PathMatchedPoint2D> matchedPoint;
+  {
+    romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+    pathMatching.enableJournal(filename);
+    drive(pathMatching, 100);
+    matchedPoint = match(pathMatching);
+    ASSERT_TRUE(matchedPoint.has_value());
+  }
+
+  std::vector<romea::core::LeaderSample> pendingLeaderSamples;
+  std::optional<romea::core::LeaderTrailState> state;
+  romea::core::LeaderTrailJournal::read(filename, pendingLeaderSamples, state);
+  ASSERT_TRUE(state.has_value());
+  ASSERT_TRUE(state->matchedPoint.has_value());
+  EXPECT_NEAR(
+    state->matchedPoint->frenetPose.curvilinearAbscissa,
+    matchedPoint->frenetPose.curvilinearAbscissa, 1e-6);
+
+  // journal rewritten on restart keeps the state
+  romea::core::OnTheFlyPathMatching restoredPathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  restoredPathMatching.enableJournal(filename);
+  romea::core::LeaderTrailJournal::read(filename, pendingLeaderSamples, state);
+  ASSERT_TRUE(state.has_value());
+  EXPECT_TRUE(state->matchedPoint.has_value());
+
+  auto restoredMatchedPoint = match(restoredPathMatching);
+  ASSERT_TRUE(restoredMatchedPoint.has_value());
+  EXPECT_NEAR(
+    restoredMatchedPoint->frenetPose.curvilinearAbscissa,
+    matchedPoint->frenetPose.curvilinearAbscissa, 1e-6);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testRestoreSimplifierPendingSamples)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1, 0.05);
+  pathMatching.enableJournal(filename);
+  drive(pathMatching, 50);
+  ASSERT_FALSE(romea::core::LeaderTrailJournal::read(filename).empty());
+
+  romea::core::OnTheFlyPathMatching restoredPathMatching(1.0, 10.0, 3.0, 0.1, 0.1, 0.05);
+  std::filesystem::copy_file(filename, filename + ".copy");
+  restoredPathMatching.enableJournal(filename + ".copy");
+
+  // both instances receive the same samples after the restart
+  size_t restartStep = step;
+  drive(pathMatching, 50);
+  step = restartStep;
+  drive(restoredPathMatching, 50);
+  std::filesystem::remove(filename + ".copy");
+
+  EXPECT_EQ(
+    restoredPathMatching.getLeaderTimeline().getStamps(),
+    pathMatching.getLeaderTimeline().getStamps());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testEnableJournalAfterPathUpdate)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  drive(pathMatching, 10);
+  EXPECT_THROW(pathMatching.enableJournal(filename), std::runtime_error);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testTornHeaderIsEmptyJournal)
+{
+  {
+    std::ofstream file(filename, std::ios::binary);
+    file.write("RPM", 3);
+  }
+  EXPECT_TRUE(romea::core::LeaderTrailJournal::read(filename).empty());
+
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  pathMatching.enableJournal(filename);
+  drive(pathMatching, 10);
+  EXPECT_EQ(
+    romea::core::LeaderTrailJournal::read(filename).size(),
+    pathMatching.getLeaderTimeline().size());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeaderTrailJournal, testInvalidJournal)
+{
+  {
+    std::ofstream file(filename);
+    file << "not a journal";
+  }
+  EXPECT_THROW(romea::core::LeaderTrailJournal::read(filename), std::runtime_error);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
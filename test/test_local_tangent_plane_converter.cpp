@@ -0,0 +1,124 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/geodesy/ENUConverter.hpp"
+#include "romea_core_path_matching/LocalTangentPlaneConverter.hpp"
+#include "romea_core_path_matching/PathLoader.hpp"
+
+class TestLocalTangentPlaneConverter : public ::testing::Test
+{
+public:
+  TestLocalTangentPlaneConverter()
+  : wgs84Anchor(romea::core::makeGeodeticCoordinates(
+        45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3))
+  {
+    // a 2 km wide spiral away from the anchor
+    for (size_t n = 0; n < 1000; ++n) {
+      double angle = n * 0.02;
+      double radius = n * 1e-5 * M_PI / 180.;
+      latitudes.push_back(wgs84Anchor.latitude + 0.005 * M_PI / 180. + radius * std::cos(angle));
+      longitudes.push_back(wgs84Anchor.longitude + 0.008 * M_PI / 180. + radius * std::sin(angle));
+    }
+  }
+
+  double maximalError(const std::vector<double> & east, const std::vector<double> & north)
+  {
+    romea::core::ENUConverter enuConverter(wgs84Anchor);
+    double error = 0;
+    for (size_t n = 0; n < latitudes.size(); ++n) {
+      Eigen::Vector3d enu = enuConverter.toENU(
+        romea::core::makeGeodeticCoordinates(latitudes[n], longitudes[n], wgs84Anchor.altitude));
+      error = std::max(error, (enu.head<2>() - Eigen::Vector2d(east[n], north[n])).norm());
+    }
+    return error;
+  }
+
+  romea::core::GeodeticCoordinates wgs84Anchor;
+  std::vector<double> latitudes;
+  std::vector<double> longitudes;
+};
+
+TEST_F(TestLocalTangentPlaneConverter, approximationRespectsAccuracyBound)
+{
+  std::vector<double> east, north;
+  romea::core::LocalTangentPlaneConverter converter(wgs84Anchor, 0.001);
+  converter.toENU(latitudes, longitudes, east, north);
+
+  EXPECT_FALSE(converter.usedExactConversion());
+  EXPECT_LE(converter.getEstimatedError(), 0.001);
+  EXPECT_LE(maximalError(east, north), 0.001);
+}
+
+TEST_F(TestLocalTangentPlaneConverter, fallbackToExactConversionWhenBoundIsTooTight)
+{
+  std::vector<double> east, north;
+  romea::core::LocalTangentPlaneConverter converter(wgs84Anchor, 1e-12);
+  converter.toENU(latitudes, longitudes, east, north);
+
+  EXPECT_TRUE(converter.usedExactConversion());
+  EXPECT_LE(maximalError(east, north), 1e-9);
+}
+
+TEST_F(TestLocalTangentPlaneConverter, loadWGS84PathFile)
+{
+  auto filename = std::filesystem::temp_directory_path() / "romea_wgs84_path_test.txt";
+  {
+    std::ofstream file(filename);
+    file << "WGS84_WAYPOINTS" << std::endl << std::setprecision(12);
+    for (size_t n = 0; n < latitudes.size(); ++n) {
+      if (n == 500) {
+        file << std::endl;
+      }
+      file << latitudes[n] * 180. / M_PI << " " << longitudes[n] * 180. / M_PI << " 1.0\n";
+    }
+  }
+
+  ASSERT_TRUE(romea::core::isWGS84PathFile(filename.string()));
+  auto wayPoints = romea::core::loadWGS84WayPoints(filename.string(), wgs84Anchor, 0.001);
+  std::filesystem::remove(filename);
+
+  ASSERT_EQ(wayPoints.size(), 2u);
+  EXPECT_EQ(wayPoints[0].size(), 500u);
+  EXPECT_EQ(wayPoints[1].size(), 500u);
+
+  std::vector<double> east, north;
+  for (const auto & sectionWayPoints : wayPoints) {
+    for (const auto & wayPoint : sectionWayPoints) {
+      east.push_back(wayPoint.position.x());
+      north.push_back(wayPoint.position.y());
+    }
+  }
+  // degrees are written with 12 significant digits, about 0.1 mm
+  EXPECT_LE(maximalError(east, north), 0.0012);
+}
+
+TEST_F(TestLocalTangentPlaneConverter, throwWhenSizesDiffer)
+{
+  std::vector<double> east, north;
+  romea::core::LocalTangentPlaneConverter converter(wgs84Anchor, 0.001);
+  latitudes.pop_back();
+  EXPECT_THROW(converter.toENU(latitudes, longitudes, east, north), std::invalid_argument);
+}
@@ -85,6 +85,158 @@ TEST_F(TestOnTheFlyPathMatching, testPathMatchingOK) {
   EXPECT_TRUE(pathMatchingPoint.has_value());
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(TestOnTheFlyPathMatching, testChangeDetectionSkipsResearches) {
+  pathMatching_.enableChangeDetection({0.05, 0.01, 0.1, 0.05});
+
+  romea::core::Twist2D follower_twist;
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.y() = 0.5;
+
+  // follower waits on the start of the trail until the leader has driven away
+  double dt = 0.1;
+  romea::core::Twist2D leader_twist;
+  leader_twist.linearSpeeds.x() = 2.0;
+  romea::core::Pose2D leader_pose;
+  std::optional<romea::core::PathMatchedPoint2D> pathMatchingPoint;
+  for (size_t i = 0; i < 100; ++i) {
+    auto stamp = romea::core::durationFromSecond(i * dt);
+    pathMatching_.updatePath(stamp, leader_pose, leader_twist);
+    leader_pose.position.x() += leader_twist.linearSpeeds.x() * dt;
+    follower_pose.position.x() = 5.0 + (i % 2 ? 0.01 : -0.01);
+    pathMatchingPoint = pathMatching_.match(stamp, follower_pose, follower_twist);
+  }
+
+  // researched until matched on the trail, skipped afterwards
+  ASSERT_TRUE(pathMatchingPoint.has_value());
+  EXPECT_GT(pathMatching_.getNumberOfSkippedResearches(), 50u);
+  EXPECT_NEAR(pathMatchingPoint->frenetPose.curvilinearAbscissa, follower_pose.position.x(), 0.2);
+  EXPECT_NEAR(pathMatchingPoint->frenetPose.lateralDeviation, 0.5, 0.1);
+
+  const size_t numberOfSkippedResearches = pathMatching_.getNumberOfSkippedResearches();
+  follower_pose.position.x() = 6.0;
+  pathMatchingPoint = pathMatching_.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  ASSERT_TRUE(pathMatchingPoint.has_value());
+  EXPECT_EQ(pathMatching_.getNumberOfSkippedResearches(), numberOfSkippedResearches);
+  EXPECT_NEAR(pathMatchingPoint->frenetPose.curvilinearAbscissa, 6.0, 0.2);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOnTheFlyPathMatchingDiagnosticsMode, testDeferredAndDisabledReports) {
+  romea::core::OnTheFlyPathMatching deferred(1.0, 10.0, 3.0, 0.1, 0.1, 0.0,
+    romea::core::DiagnosticsMode::DEFERRED);
+  romea::core::OnTheFlyPathMatching disabled(1.0, 10.0, 3.0, 0.1, 0.1, 0.0,
+    romea::core::DiagnosticsMode::DISABLED);
+
+  double dt = 0.1;
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+  romea::core::Pose2D leader_pose;
+  leader_pose.position.x() = 10.0;
+  romea::core::Pose2D follower_pose;
+  for (size_t i = 0; i <= 10; ++i) {
+    auto stamp = romea::core::durationFromSecond(i * dt);
+    for (auto * pathMatching : {&deferred, &disabled}) {
+      pathMatching->updatePath(stamp, leader_pose, twist);
+      pathMatching->match(stamp, follower_pose, twist);
+    }
+    leader_pose.position.x() += twist.linearSpeeds.x() * dt;
+    follower_pose.position.x() += twist.linearSpeeds.x() * dt;
+  }
+
+  auto report = deferred.getReport(romea::core::durationFromSecond(1.0));
+  EXPECT_EQ(report.diagnostics.front().status, romea::core::DiagnosticStatus::OK);
+  EXPECT_STREQ(report.info["leader_localisation_rate"].c_str(), "10");
+  EXPECT_STREQ(report.info["follower_localisation_rate"].c_str(), "10");
+
+  report = disabled.getReport(romea::core::durationFromSecond(1.0));
+  EXPECT_TRUE(report.diagnostics.empty());
+  EXPECT_TRUE(report.info.empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOnTheFlyPathMatchingSimplification, testPathMatchingOK) {
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1, 0.01);
+
+  double dt = 0.1;
+  romea::core::Twist2D leader_twist;
+  leader_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D leader_pose;
+  size_t numberOfInsertedPoints = 0;
+  for (size_t i = 0; i < 100; ++i) {
+    numberOfInsertedPoints += pathMatching.updatePath(
+      romea::core::durationFromSecond(i * dt), leader_pose, leader_twist);
+    leader_pose.position.x() += leader_twist.linearSpeeds.x() * dt;
+  }
+  EXPECT_LT(numberOfInsertedPoints, 20);
+
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.x() = 10;
+  follower_pose.position.y() = 1;
+
+  auto pathMatchingPoint = pathMatching.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist);
+
+  EXPECT_TRUE(pathMatchingPoint.has_value());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOnTheFlyPathMatchingArchiving, testArchivedTrailIsRestoredWhenReached) {
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  romea::core::OnTheFlyPathMatching referencePathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  pathMatching.enableTrailArchiving(15.0);
+
+  double dt = 0.1;
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+
+  // follower drives 20 m behind the leader along a 400 m trail
+  romea::core::Pose2D leader_pose;
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.y() = 0.5;
+  for (size_t i = 0; i < 2000; ++i) {
+    auto stamp = romea::core::durationFromSecond(i * dt);
+    leader_pose.position.x() = i * twist.linearSpeeds.x() * dt;
+    pathMatching.updatePath(stamp, leader_pose, twist);
+    referencePathMatching.updatePath(stamp, leader_pose, twist);
+
+    follower_pose.position.x() = leader_pose.position.x() - 20;
+    if (follower_pose.position.x() < 0) {
+      continue;
+    }
+
+    auto matchedPoint = pathMatching.match(stamp, follower_pose, twist);
+    auto referenceMatchedPoint = referencePathMatching.match(stamp, follower_pose, twist);
+    ASSERT_TRUE(matchedPoint.has_value());
+    ASSERT_TRUE(referenceMatchedPoint.has_value());
+    EXPECT_NEAR(
+      matchedPoint->frenetPose.curvilinearAbscissa,
+      referenceMatchedPoint->frenetPose.curvilinearAbscissa, 1e-6);
+    EXPECT_EQ(
+      pathMatching.getLeaderStamp(*matchedPoint),
+      referencePathMatching.getLeaderStamp(*referenceMatchedPoint));
+  }
+
+  // only the last tens of meters are kept at full resolution
+  EXPECT_LT(pathMatching.getLeaderTimeline().size(), 600u);
+  EXPECT_GT(pathMatching.getTrailArchive().size(), 1400u);
+
+  // follower is moved back near the start of the trail
+  pathMatching.reset();
+  follower_pose.position.x() = 5;
+  auto matchedPoint = pathMatching.match(
+    romea::core::durationFromSecond(200), follower_pose, twist);
+  ASSERT_TRUE(matchedPoint.has_value());
+  EXPECT_NEAR(matchedPoint->frenetPose.curvilinearAbscissa, 5, 0.3);
+  EXPECT_NEAR(
+    romea::core::durationToSecond(*pathMatching.getLeaderStamp(*matchedPoint)), 2.5, 0.1);
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char ** argv)
 {
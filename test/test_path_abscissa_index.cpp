@@ -0,0 +1,160 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cmath>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PathAbscissaIndex.hpp"
+
+class TestPathAbscissaIndex : public ::testing::Test
+{
+public:
+  TestPathAbscissaIndex()
+  : path(makeWayPoints(), 3.0),
+    pathIndex(path),
+    abscissaIndex(path)
+  {
+  }
+
+  // serpentine made of 10 m swaths and 3 m headland turns, each one in its own section
+  static std::vector<std::vector<romea::core::PathWayPoint2D>> makeWayPoints()
+  {
+    std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints;
+    for (size_t n = 0; n < 100; ++n) {
+      double y = 3.0 * n;
+      double direction = n % 2 ? -1 : 1;
+      double x0 = n % 2 ? 10 : 0;
+
+      auto & swath = wayPoints.emplace_back();
+      for (size_t i = 0; i <= 50; ++i) {
+        swath.emplace_back(Eigen::Vector2d(x0 + direction * 0.2 * i, y), 1.0);
+      }
+
+      auto & turn = wayPoints.emplace_back();
+      for (size_t i = 0; i <= 15; ++i) {
+        turn.emplace_back(Eigen::Vector2d(x0 + direction * 10, y + 0.2 * i), 1.0);
+      }
+    }
+    return wayPoints;
+  }
+
+  romea::core::Path2D path;
+  romea::core::CoarsePathIndex pathIndex;
+  romea::core::PathAbscissaIndex abscissaIndex;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAbscissaIndex, cumulativeAbscissas)
+{
+  ASSERT_EQ(abscissaIndex.size(), 200u);
+  EXPECT_NEAR(abscissaIndex.getSectionInitialCurvilinearAbscissa(0), 0.0, 1e-9);
+  EXPECT_NEAR(abscissaIndex.getSectionFinalCurvilinearAbscissa(0), 10.0, 1e-9);
+  EXPECT_NEAR(abscissaIndex.getSectionInitialCurvilinearAbscissa(1), 10.0, 1e-9);
+  EXPECT_NEAR(abscissaIndex.getSectionFinalCurvilinearAbscissa(199), 1300.0, 1e-6);
+  EXPECT_NEAR(abscissaIndex.getCurvilinearAbscissa(2, 5), 14.0, 1e-9);
+  EXPECT_EQ(abscissaIndex.getSectionOffset(2), 67u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAbscissaIndex, updateSection)
+{
+  // second swath is cut by half
+  auto wayPoints = makeWayPoints();
+  wayPoints[2].resize(26);
+  romea::core::Path2D splicedPath(wayPoints, 3.0);
+
+  abscissaIndex.updateSection(2, splicedPath.getSection(2));
+  romea::core::PathAbscissaIndex expectedIndex(splicedPath);
+
+  ASSERT_EQ(
+    abscissaIndex.getCurvilinearAbscissas().size(),
+    expectedIndex.getCurvilinearAbscissas().size());
+  for (size_t n = 0; n < expectedIndex.getCurvilinearAbscissas().size(); ++n) {
+    EXPECT_NEAR(
+      abscissaIndex.getCurvilinearAbscissas()[n], expectedIndex.getCurvilinearAbscissas()[n], 1e-6);
+  }
+  for (size_t s = 0; s < expectedIndex.size(); ++s) {
+    EXPECT_EQ(abscissaIndex.getSectionOffset(s), expectedIndex.getSectionOffset(s));
+    EXPECT_NEAR(
+      abscissaIndex.getSectionInitialCurvilinearAbscissa(s),
+      expectedIndex.getSectionInitialCurvilinearAbscissa(s), 1e-6);
+  }
+  EXPECT_NEAR(abscissaIndex.getSectionFinalCurvilinearAbscissa(199), 1295.0, 1e-6);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAbscissaIndex, locate)
+{
+  EXPECT_EQ(abscissaIndex.findSection(-1.0), 0u);
+  EXPECT_EQ(abscissaIndex.findSection(5.0), 0u);
+  EXPECT_EQ(abscissaIndex.findSection(11.0), 1u);
+  EXPECT_EQ(abscissaIndex.findSection(650.5), 100u);
+  EXPECT_EQ(abscissaIndex.findSection(2000.0), 199u);
+
+  auto [sectionIndex, wayPointIndex] = abscissaIndex.locate(14.1);
+  EXPECT_EQ(sectionIndex, 2u);
+  EXPECT_EQ(wayPointIndex, 5u);
+
+  auto [firstSection, lastSection] = abscissaIndex.findSections(9.0, 14.0);
+  EXPECT_EQ(firstSection, 0u);
+  EXPECT_EQ(lastSection, 2u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAbscissaIndex, nextAndPreviousSections)
+{
+  EXPECT_EQ(abscissaIndex.nextSection(0), 1u);
+  EXPECT_FALSE(abscissaIndex.nextSection(199).has_value());
+  EXPECT_EQ(abscissaIndex.previousSection(199), 198u);
+  EXPECT_FALSE(abscissaIndex.previousSection(0).has_value());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAbscissaIndex, trackingFollowsSectionTransitions)
+{
+  romea::core::Pose2D pose;
+  pose.position = Eigen::Vector2d(1.0, 0.2);
+  auto matchedPoints = romea::core::matchCoarseToFine(path, pathIndex, pose, 1.0, 0.0, 1.0);
+  ASSERT_FALSE(matchedPoints.empty());
+
+  // drive along the first swaths and turns
+  auto seed = matchedPoints[0];
+  for (const auto & section : std::vector<size_t>{0, 1, 2, 3, 4}) {
+    const auto & X = path.getSection(section).getX();
+    const auto & Y = path.getSection(section).getY();
+    for (size_t n = 0; n < X.size(); ++n) {
+      pose.position = Eigen::Vector2d(X[n], Y[n] + 0.1);
+      matchedPoints = romea::core::matchInTrackingWindow(
+        path, pathIndex, abscissaIndex, pose, 1.0, seed, 2.0, 0.0, 1.0);
+      ASSERT_FALSE(matchedPoints.empty());
+
+      seed = *std::min_element(
+        matchedPoints.begin(), matchedPoints.end(), [](const auto & p1, const auto & p2) {
+          return std::abs(p1.frenetPose.lateralDeviation) <
+          std::abs(p2.frenetPose.lateralDeviation);
+        });
+      // swaths 3 m apart are never matched while tracking
+      EXPECT_LE(seed.sectionIndex, section + 1);
+      EXPECT_GE(seed.sectionIndex + 1, section);
+    }
+  }
+  EXPECT_GE(seed.sectionIndex, 4u);
+}
@@ -0,0 +1,114 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PathAnnotationIndex.hpp"
+
+class TestPathAnnotationIndex : public ::testing::Test
+{
+public:
+  TestPathAnnotationIndex()
+  : path(makeWayPoints(), 3.0, makeAnnotations()),
+    abscissaIndex(path),
+    annotationIndex(path, abscissaIndex)
+  {
+  }
+
+  // two straight sections of 10 m sampled every 0.5 m, the second one going back
+  static std::vector<std::vector<romea::core::PathWayPoint2D>> makeWayPoints()
+  {
+    std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints(2);
+    for (size_t i = 0; i <= 20; ++i) {
+      wayPoints[0].emplace_back(Eigen::Vector2d(0.5 * i, 0), 1.0);
+      wayPoints[1].emplace_back(Eigen::Vector2d(10 - 0.5 * i, 1), -1.0);
+    }
+    return wayPoints;
+  }
+
+  // not sorted, point indexes count way points of both sections
+  static romea::core::PathAnnotations makeAnnotations()
+  {
+    return {
+      {"speed_limit", "0.5", 30},
+      {"implement", "up", 4},
+      {"implement", "down", 25},
+      {"turn_zone", "begin", 25},
+      {"implement", "up", 100}};
+  }
+
+  romea::core::Path2D path;
+  romea::core::PathAbscissaIndex abscissaIndex;
+  romea::core::PathAnnotationIndex annotationIndex;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAnnotationIndex, annotationsAreSortedByAbscissa)
+{
+  const auto & annotations = annotationIndex.getAnnotations();
+  ASSERT_EQ(annotations.size(), 4u);
+  EXPECT_NEAR(annotations[0].curvilinearAbscissa, 2.0, 1e-9);
+  EXPECT_EQ(annotations[1].annotation.value, "down");
+  EXPECT_EQ(annotations[2].annotation.type, "turn_zone");
+  EXPECT_NEAR(annotations[2].curvilinearAbscissa, 12.0, 1e-9);
+  EXPECT_NEAR(annotations[3].curvilinearAbscissa, 14.5, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAnnotationIndex, findAhead)
+{
+  auto range = annotationIndex.find(1.0, 12.0);
+  ASSERT_EQ(range.size(), 3u);
+  EXPECT_EQ(range.begin()->annotation.pointIndex, 4u);
+  EXPECT_EQ((range.end() - 1)->annotation.pointIndex, 25u);
+
+  EXPECT_EQ(annotationIndex.find(12.0, 2.5).size(), 3u);
+  EXPECT_TRUE(annotationIndex.find(2.5, 9.0).empty());
+  EXPECT_TRUE(annotationIndex.find(15.0, 100.0).empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAnnotationIndex, findBehind)
+{
+  auto range = annotationIndex.find(12.5, -11.0);
+  ASSERT_EQ(range.size(), 3u);
+  EXPECT_EQ(range.begin()->annotation.value, "up");
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathAnnotationIndex, matchedPointAbscissa)
+{
+  romea::core::PathMatchedPoint2D matchedPoint;
+  matchedPoint.sectionIndex = 1;
+  matchedPoint.curveIndex = 3;
+  matchedPoint.pathPosture.position = Eigen::Vector2d(8.3, 1.0);
+  matchedPoint.pathPosture.course = M_PI;
+
+  EXPECT_NEAR(
+    romea::core::matchedPointCurvilinearAbscissa(path, abscissaIndex, matchedPoint), 11.7, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathAnnotationIndexEmpty, noAnnotations)
+{
+  romea::core::PathAnnotationIndex annotationIndex;
+  EXPECT_TRUE(annotationIndex.empty());
+  EXPECT_TRUE(annotationIndex.find(0.0, 10.0).empty());
+}
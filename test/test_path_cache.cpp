@@ -0,0 +1,168 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// romea
+#include "../test/test_helper.h"
+#include "romea_core_path_matching/PathCache.hpp"
+#include "romea_core_path_matching/PathLoader.hpp"
+
+class TestPathCache : public ::testing::Test
+{
+public:
+  TestPathCache()
+  : directory((std::filesystem::temp_directory_path() / "romea_path_cache_test").string()),
+    pathFilename(std::string(TEST_DIR) + "/test_path_matching.cvs"),
+    wgs84Anchor(romea::core::makeGeodeticCoordinates(
+        45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3))
+  {
+    std::filesystem::remove_all(directory);
+  }
+
+  ~TestPathCache() override
+  {
+    std::filesystem::remove_all(directory);
+  }
+
+  romea::core::CachedPath makePath()
+  {
+    romea::core::CachedPath path;
+    auto & wayPoints = path.wayPoints;
+    wayPoints.resize(2);
+    for (size_t n = 0; n < 10; ++n) {
+      wayPoints[0].emplace_back(Eigen::Vector2d(n, 0), 1.0);
+      wayPoints[1].emplace_back(Eigen::Vector2d(10, n), -1.0);
+    }
+    return path;
+  }
+
+  std::string directory;
+  std::string pathFilename;
+  romea::core::GeodeticCoordinates wgs84Anchor;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathCache, testStoreAndLoad)
+{
+  romea::core::PathCache cache(directory);
+  romea::core::PathCacheKey key{42, wgs84Anchor, 3.0, 0.001};
+  EXPECT_FALSE(cache.load(key).has_value());
+
+  cache.store(key, makePath());
+  auto cachedPath = cache.load(key);
+  ASSERT_TRUE(cachedPath.has_value());
+  const auto & wayPoints = cachedPath->wayPoints;
+  ASSERT_EQ(wayPoints.size(), 2);
+  ASSERT_EQ(wayPoints[1].size(), 10);
+  EXPECT_DOUBLE_EQ(wayPoints[1][9].position.x(), 10);
+  EXPECT_DOUBLE_EQ(wayPoints[1][9].position.y(), 9);
+  EXPECT_DOUBLE_EQ(wayPoints[1][9].desiredSpeed, -1.0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathCache, testStaleEntries)
+{
+  romea::core::PathCache cache(directory);
+  romea::core::PathCacheKey key{42, wgs84Anchor, 3.0, 0.001};
+  cache.store(key, makePath());
+
+  romea::core::PathCacheKey otherWindowKey{42, wgs84Anchor, 2.0, 0.001};
+  EXPECT_FALSE(cache.load(otherWindowKey).has_value());
+
+  romea::core::PathCacheKey otherFileKey{43, wgs84Anchor, 3.0, 0.001};
+  EXPECT_FALSE(cache.load(otherFileKey).has_value());
+
+  romea::core::PathCacheKey otherConversionErrorKey{42, wgs84Anchor, 3.0, 0.01};
+  EXPECT_NE(otherConversionErrorKey.hash(), key.hash());
+  EXPECT_FALSE(cache.load(otherConversionErrorKey).has_value());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathCache, testAnnotationsAreCached)
+{
+  romea::core::PathCache cache(directory);
+  romea::core::PathCacheKey key{42, wgs84Anchor, 3.0, 0.001};
+  auto path = makePath();
+  path.annotations = {{"implement", "up", 4}, {"speed_limit", "0.5", 15}};
+  cache.store(key, path);
+
+  auto cachedPath = cache.load(key);
+  ASSERT_TRUE(cachedPath.has_value());
+  ASSERT_EQ(cachedPath->annotations.size(), 2u);
+  EXPECT_EQ(cachedPath->annotations[1].type, "speed_limit");
+  EXPECT_EQ(cachedPath->annotations[1].value, "0.5");
+  EXPECT_EQ(cachedPath->annotations[1].pointIndex, 15u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathCache, testCorruptedEntry)
+{
+  romea::core::PathCache cache(directory);
+  romea::core::PathCacheKey key{42, wgs84Anchor, 3.0, 0.001};
+  cache.store(key, makePath());
+
+  std::filesystem::resize_file(cache.getEntryFilename(key), 100);
+  EXPECT_FALSE(cache.load(key).has_value());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathCache, testUncreatableDirectoryDisablesCache)
+{
+  // a regular file stands where the cache directory parent should be
+  std::filesystem::create_directories(directory);
+  std::ofstream(directory + "/file") << "not a directory";
+  const std::string uncreatableDirectory = directory + "/file/cache";
+
+  romea::core::PathCache cache(uncreatableDirectory);
+  EXPECT_FALSE(cache.isEnabled());
+  romea::core::PathCacheKey key{42, wgs84Anchor, 3.0, 0.001};
+  cache.store(key, makePath());
+  EXPECT_FALSE(cache.load(key).has_value());
+
+  auto reference = romea::core::loadPath(pathFilename, wgs84Anchor, 3.0);
+  auto path = romea::core::loadPath(pathFilename, wgs84Anchor, 3.0, uncreatableDirectory);
+  ASSERT_EQ(path.size(), reference.size());
+  EXPECT_EQ(path.getSection(0).getX(), reference.getSection(0).getX());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathCache, testLoadPathWithCache)
+{
+  auto reference = romea::core::loadPath(pathFilename, wgs84Anchor, 3.0);
+  romea::core::loadPath(pathFilename, wgs84Anchor, 3.0, directory);
+
+  auto key = romea::core::makePathCacheKey(
+    pathFilename, wgs84Anchor, 3.0, romea::core::DEFAULT_WGS84_CONVERSION_MAXIMAL_ERROR);
+  EXPECT_TRUE(romea::core::PathCache(directory).load(key).has_value());
+
+  auto cachedPath = romea::core::loadPath(pathFilename, wgs84Anchor, 3.0, directory);
+  ASSERT_EQ(cachedPath.size(), reference.size());
+  EXPECT_EQ(cachedPath.getSection(0).getX(), reference.getSection(0).getX());
+  EXPECT_EQ(cachedPath.getSection(0).getY(), reference.getSection(0).getY());
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
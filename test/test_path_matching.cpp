@@ -17,8 +17,13 @@
 #include <gtest/gtest.h>
 
 // std
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <random>
 #include <string>
+#include <vector>
 
 // romea
 #include "../test/test_helper.h"
@@ -72,6 +77,472 @@ TEST_F(TestPathMatching, testPathMatchingOK)
   EXPECT_FALSE(pathMatchingPoints.empty());
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testManoeuvreKeepsTracking)
+{
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.y() = 0.5;
+  romea::core::Twist2D follower_twist;
+
+  // forward, reverse and forward again with a prediction horizon
+  double stamp = 10;
+  auto drive = [&](const double & from, const double & to, const double & speed) {
+      follower_twist.linearSpeeds.x() = speed;
+      for (double x = from; speed * (to - x) > 0; x += speed * 0.1) {
+        follower_pose.position.x() = x;
+        auto pathMatchingPoints = pathMatching.match(
+          romea::core::durationFromSecond(stamp += 0.1), follower_pose, follower_twist, 1.0);
+        ASSERT_FALSE(pathMatchingPoints.empty());
+        EXPECT_NEAR(pathMatchingPoints[0].pathPosture.position.x(), x, 0.5);
+      }
+    };
+
+  drive(2.0, 12.0, 2.0);
+  drive(12.0, 4.0, -1.0);
+  drive(4.0, 15.0, 2.0);
+
+  EXPECT_EQ(pathMatching.getNumberOfGlobalResearches(), 1u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testSplicePathKeepsTracking)
+{
+  pathMatching.enablePostureTable();
+
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.x() = 2;
+  follower_pose.position.y() = 0.5;
+
+  ASSERT_FALSE(pathMatching.match(
+      romea::core::durationFromSecond(10), follower_pose, follower_twist).empty());
+
+  const auto & section = pathMatching.getPath().getSection(0);
+  const size_t size = section.size();
+  const double length = pathMatching.getPostureTable().getMaximalCurvilinearAbscissa();
+
+  // replan the end of the path 1 m to the left
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 50; n < size; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(section.getX()[n], section.getY()[n] + 1.0), 1.0);
+  }
+  pathMatching.splicePath(0, 50, size, wayPoints);
+
+  EXPECT_EQ(pathMatching.getPath().getSection(0).size(), size);
+  EXPECT_DOUBLE_EQ(pathMatching.getPath().getSection(0).getY().back(), 1.0);
+  EXPECT_GT(pathMatching.getPostureTable().getMaximalCurvilinearAbscissa(), length);
+  EXPECT_NEAR(pathMatching.getPostureTable().lookup(1.0).position.y(), 0.0, 1e-6);
+  EXPECT_NEAR(pathMatching.getPostureTable().lookup(18.0).position.y(), 1.0, 1e-6);
+
+  // tracking goes on from the remapped matched point without any global research
+  const size_t numberOfGlobalResearches = pathMatching.getNumberOfGlobalResearches();
+  follower_pose.position.x() = 2.5;
+  ASSERT_FALSE(pathMatching.match(
+      romea::core::durationFromSecond(10.1), follower_pose, follower_twist).empty());
+  EXPECT_EQ(pathMatching.getNumberOfGlobalResearches(), numberOfGlobalResearches);
+
+  follower_pose.position.x() = 15;
+  follower_pose.position.y() = 1.5;
+  auto pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.2), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_NEAR(pathMatchingPoints[0].pathPosture.position.y(), 1.0, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testPostureTableIsBuiltOnlyOnceEnabled)
+{
+  EXPECT_THROW(pathMatching.getPostureTable(), std::runtime_error);
+  EXPECT_THROW(pathMatching.enablePostureTable(0.), std::invalid_argument);
+
+  pathMatching.enablePostureTable(0.5);
+  EXPECT_DOUBLE_EQ(pathMatching.getPostureTable().getSamplingStep(), 0.5);
+  EXPECT_FALSE(pathMatching.getPostureTable().empty());
+
+  // next paths are sampled at the same step
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n < 100; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(n * 0.2, 0.), 1.0);
+  }
+  pathMatching.setPath(romea::core::Path2D({wayPoints}, 3.0));
+  EXPECT_DOUBLE_EQ(pathMatching.getPostureTable().getSamplingStep(), 0.5);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testCompactPostureTable)
+{
+  pathMatching.enablePostureTable();
+  const auto & table = pathMatching.getPostureTable();
+  const auto posture = table.lookup(5.0);
+  const size_t memoryUsage = table.getMemoryUsage();
+
+  pathMatching.enableCompactPostureTable();
+  EXPECT_TRUE(pathMatching.getPostureTable().isCompact());
+  EXPECT_LT(pathMatching.getPostureTable().getMemoryUsage() * 3, memoryUsage);
+  EXPECT_NEAR((pathMatching.getPostureTable().lookup(5.0).position - posture.position).norm(),
+    0, 0.001);
+
+  // next paths are compacted too
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n < 100; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(n * 0.2, 0.), 1.0);
+  }
+  pathMatching.setPath(romea::core::Path2D({wayPoints}, 3.0));
+  EXPECT_TRUE(pathMatching.getPostureTable().isCompact());
+
+  // paths with a gap are swapped in with a full precision posture table
+  std::vector<romea::core::PathWayPoint2D> farWayPoints;
+  for (size_t n = 0; n < 100; ++n) {
+    farWayPoints.emplace_back(Eigen::Vector2d(100 + n * 0.2, 0.), 1.0);
+  }
+  EXPECT_NO_THROW(pathMatching.setPath(romea::core::Path2D({wayPoints, farWayPoints}, 3.0)));
+  EXPECT_FALSE(pathMatching.getPostureTable().isCompact());
+  EXPECT_EQ(pathMatching.getPath().size(), 2u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testMatchedPointsAnnotations)
+{
+  std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints(1);
+  for (size_t n = 0; n <= 200; ++n) {
+    wayPoints[0].emplace_back(Eigen::Vector2d(0.1 * n, 0), 1.0);
+  }
+  pathMatching.setPath(
+    romea::core::Path2D(wayPoints, 3.0, {{"implement", "up", 50}, {"implement", "down", 150}}));
+  pathMatching.setAnnotationLookaheadDistance(6.0);
+  EXPECT_THROW(pathMatching.setAnnotationLookaheadDistance(-1.0), std::invalid_argument);
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position = Eigen::Vector2d(2.0, 0.3);
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 1.0;
+
+  auto pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  auto annotations = pathMatching.getMatchedPointsAnnotations();
+  ASSERT_EQ(annotations.size(), pathMatchingPoints.size());
+  ASSERT_EQ(annotations[0].size(), 1u);
+  EXPECT_EQ(annotations[0].begin()->annotation.value, "up");
+  EXPECT_EQ(pathMatching.nextAnnotations(pathMatchingPoints[0], 15.0).size(), 2u);
+
+  // annotations are looked for behind the vehicle when reversing
+  follower_pose.position.x() = 16.0;
+  follower_twist.linearSpeeds.x() = -1.0;
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.1), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  annotations = pathMatching.getMatchedPointsAnnotations();
+  ASSERT_EQ(annotations[0].size(), 1u);
+  EXPECT_EQ(annotations[0].begin()->annotation.value, "down");
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testMatchedPointsAnnotationsOnReverseSection)
+{
+  std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints(1);
+  for (size_t n = 0; n <= 200; ++n) {
+    wayPoints[0].emplace_back(Eigen::Vector2d(0.1 * n, 0), -1.0);
+  }
+  pathMatching.setPath(
+    romea::core::Path2D(wayPoints, 3.0, {{"implement", "up", 50}, {"implement", "down", 150}}));
+  pathMatching.setAnnotationLookaheadDistance(6.0);
+
+  // driving backward on a reverse section moves along the path
+  romea::core::Pose2D follower_pose;
+  follower_pose.position = Eigen::Vector2d(2.0, 0.3);
+  follower_pose.yaw = M_PI;
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = -1.0;
+
+  auto pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  auto annotations = pathMatching.getMatchedPointsAnnotations();
+  ASSERT_EQ(annotations.size(), pathMatchingPoints.size());
+  ASSERT_EQ(annotations[0].size(), 1u);
+  EXPECT_EQ(annotations[0].begin()->annotation.value, "up");
+
+  // driving forward on it moves back along the path
+  follower_pose.position.x() = 16.0;
+  follower_twist.linearSpeeds.x() = 1.0;
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.1), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  annotations = pathMatching.getMatchedPointsAnnotations();
+  ASSERT_EQ(annotations[0].size(), 1u);
+  EXPECT_EQ(annotations[0].begin()->annotation.value, "down");
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testChangeDetectionSkipsResearches)
+{
+  pathMatching.enableChangeDetection({0.05, 0.01, 0.1, 0.05});
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position = Eigen::Vector2d(5.0, 0.5);
+  romea::core::Twist2D follower_twist;
+
+  // vehicle waiting with a noisy localisation, then moving away
+  double stamp = 10;
+  std::vector<romea::core::PathMatchedPoint2D> pathMatchingPoints;
+  for (size_t n = 0; n < 20; ++n) {
+    follower_pose.position.x() = 5.0 + (n % 2 ? 0.01 : -0.01);
+    pathMatchingPoints = pathMatching.match(
+      romea::core::durationFromSecond(stamp += 0.1), follower_pose, follower_twist);
+    ASSERT_FALSE(pathMatchingPoints.empty());
+  }
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 19u);
+  EXPECT_NEAR(pathMatchingPoints[0].pathPosture.position.x(), follower_pose.position.x(), 0.2);
+
+  follower_pose.position.x() = 6.0;
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(stamp += 0.1), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 19u);
+  EXPECT_NEAR(pathMatchingPoints[0].pathPosture.position.x(), 6.0, 0.2);
+
+  // skipped calls still feed localisation rate and matching status diagnostics
+  auto report = pathMatching.getReport(romea::core::durationFromSecond(stamp));
+  EXPECT_EQ(report.diagnostics.front().status, romea::core::DiagnosticStatus::OK);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testExtrapolationStaysOnMatchedCurve)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n <= 200; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(0.1 * n, 0), 1.0);
+  }
+  pathMatching.setPath(romea::core::Path2D({wayPoints}, 3.0));
+  pathMatching.enableChangeDetection({1.0, 0.1, 0.5, 0.5});
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position = Eigen::Vector2d(5.0, 0.2);
+  romea::core::Twist2D follower_twist;
+
+  auto pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+
+  follower_pose.position.x() = 5.02;
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.1), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 1u);
+
+  // below change thresholds but past the way points around the matched curve
+  follower_pose.position.x() = 5.5;
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.2), follower_pose, follower_twist);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 1u);
+  EXPECT_NEAR(pathMatchingPoints[0].pathPosture.position.x(), 5.5, 0.05);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testPredictionTimeHorizonChangeForcesResearch)
+{
+  pathMatching.enableChangeDetection({0.05, 0.01, 0.1, 0.05});
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position = Eigen::Vector2d(5.0, 0.5);
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 1.0;
+
+  auto pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist, 0.);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.1), follower_pose, follower_twist, 0.);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 1u);
+
+  // same pose matched further ahead is researched, then skipped again with that horizon
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.2), follower_pose, follower_twist, 1.);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 1u);
+  pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10.3), follower_pose, follower_twist, 1.);
+  ASSERT_FALSE(pathMatchingPoints.empty());
+  EXPECT_EQ(pathMatching.getNumberOfSkippedResearches(), 2u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathMatchingDiagnosticsMode, testDeferredAndDisabledReports)
+{
+  auto anchor = romea::core::makeGeodeticCoordinates(
+    45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3);
+  const std::string filename = std::string(TEST_DIR) + "/test_path_matching.cvs";
+  romea::core::PathMatching synchronous(filename, anchor, 10.0, 3.0, "",
+    romea::core::DiagnosticsMode::SYNCHRONOUS);
+  romea::core::PathMatching deferred(filename, anchor, 10.0, 3.0, "",
+    romea::core::DiagnosticsMode::DEFERRED);
+  romea::core::PathMatching disabled(filename, anchor, 10.0, 3.0, "",
+    romea::core::DiagnosticsMode::DISABLED);
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position = Eigen::Vector2d(5.0, 0.5);
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 1.0;
+
+  for (size_t n = 0; n <= 10; ++n) {
+    auto stamp = romea::core::durationFromSecond(n * 0.1);
+    follower_pose.position.x() += 0.1;
+    EXPECT_EQ(
+      deferred.match(stamp, follower_pose, follower_twist).size(),
+      synchronous.match(stamp, follower_pose, follower_twist).size());
+    disabled.match(stamp, follower_pose, follower_twist);
+  }
+
+  auto expected = synchronous.getReport(romea::core::durationFromSecond(1.0));
+  auto report = deferred.getReport(romea::core::durationFromSecond(1.0));
+  EXPECT_EQ(report.diagnostics.size(), expected.diagnostics.size());
+  EXPECT_EQ(report.info["localisation_rate"], expected.info["localisation_rate"]);
+  EXPECT_STREQ(report.info["path_matching"].c_str(), "true");
+
+  report = disabled.getReport(romea::core::durationFromSecond(1.0));
+  EXPECT_TRUE(report.diagnostics.empty());
+  EXPECT_TRUE(report.info.empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testSplicePathOutOfRange)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  EXPECT_THROW(pathMatching.splicePath(1, 0, 0, wayPoints), std::out_of_range);
+  EXPECT_THROW(pathMatching.splicePath(0, 10, 5, wayPoints), std::out_of_range);
+  EXPECT_THROW(pathMatching.splicePath(0, 0, 1000, wayPoints), std::out_of_range);
+}
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testLoadPathAsyncIsSwappedByMatch)
+{
+  pathMatching.enablePostureTable();
+  auto filename = std::filesystem::temp_directory_path() / "romea_async_path_test.txt";
+  {
+    std::ofstream file(filename);
+    file << "WGS84_WAYPOINTS" << std::endl;
+    for (size_t n = 0; n < 50; ++n) {
+      file << "45.763066 " << 3.1093255 + n * 1e-5 << " 1.0" << std::endl;
+    }
+  }
+
+  auto future = pathMatching.loadPathAsync(
+    filename.string(),
+    romea::core::makeGeodeticCoordinates(45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3));
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  std::filesystem::remove(filename);
+  EXPECT_NO_THROW(future.get());
+
+  // published path is only swapped in by the control thread
+  EXPECT_EQ(pathMatching.getPath().getSection(0).size(), 100u);
+
+  romea::core::Twist2D follower_twist;
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.x() = 10;
+  pathMatching.match(romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  EXPECT_EQ(pathMatching.getPath().getSection(0).size(), 50u);
+  EXPECT_FALSE(pathMatching.getPostureTable().empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testLoadPathAsyncReportsErrors)
+{
+  auto filename = std::filesystem::temp_directory_path() / "romea_async_path_error_test.txt";
+  {
+    std::ofstream file(filename);
+    file << "WGS84_WAYPOINTS" << std::endl << "45.763066" << std::endl;
+  }
+
+  auto future = pathMatching.loadPathAsync(
+    filename.string(),
+    romea::core::makeGeodeticCoordinates(45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3));
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  std::filesystem::remove(filename);
+  EXPECT_THROW(future.get(), std::runtime_error);
+
+  romea::core::Twist2D follower_twist;
+  romea::core::Pose2D follower_pose;
+  pathMatching.match(romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  EXPECT_EQ(pathMatching.getPath().getSection(0).size(), 100u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testLoadPathAsyncPublishesOnlyLatestRequest)
+{
+  auto writePath = [](const std::string & name, const size_t & numberOfWayPoints) {
+      auto filename = std::filesystem::temp_directory_path() / name;
+      std::ofstream file(filename);
+      file << "WGS84_WAYPOINTS" << std::endl;
+      for (size_t n = 0; n < numberOfWayPoints; ++n) {
+        file << "45.763066 " << 3.1093255 + n * 1e-5 << " 1.0" << std::endl;
+      }
+      return filename;
+    };
+
+  auto firstFilename = writePath("romea_async_first_path_test.txt", 30);
+  auto secondFilename = writePath("romea_async_second_path_test.txt", 40);
+  const auto wgs84Anchor = romea::core::makeGeodeticCoordinates(
+    45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3);
+
+  auto firstFuture = pathMatching.loadPathAsync(firstFilename.string(), wgs84Anchor);
+  auto secondFuture = pathMatching.loadPathAsync(secondFilename.string(), wgs84Anchor);
+  ASSERT_EQ(firstFuture.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(secondFuture.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  EXPECT_THROW(firstFuture.get(), std::runtime_error);
+  EXPECT_NO_THROW(secondFuture.get());
+
+  romea::core::Twist2D follower_twist;
+  romea::core::Pose2D follower_pose;
+  pathMatching.match(romea::core::durationFromSecond(10), follower_pose, follower_twist);
+  EXPECT_EQ(pathMatching.getPath().getSection(0).size(), 40u);
+  auto report = pathMatching.getReport(romea::core::durationFromSecond(10));
+  EXPECT_EQ(report.info["path_file_name"], "romea_async_second_path_test.txt");
+
+  // a path set meanwhile supersedes the loaded one
+  auto thirdFuture = pathMatching.loadPathAsync(firstFilename.string(), wgs84Anchor);
+  ASSERT_EQ(thirdFuture.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n < 20; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(n * 0.5, 0.), 1.0);
+  }
+  pathMatching.setPath(romea::core::Path2D({wayPoints}, 3.0));
+  pathMatching.match(romea::core::durationFromSecond(10.1), follower_pose, follower_twist);
+  EXPECT_EQ(pathMatching.getPath().getSection(0).size(), 20u);
+
+  std::filesystem::remove(firstFilename);
+  std::filesystem::remove(secondFilename);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathMatching, testDestructorJoinsLoaderThreads)
+{
+  auto filename = std::filesystem::temp_directory_path() / "romea_async_joined_path_test.txt";
+  {
+    std::ofstream file(filename);
+    file << "WGS84_WAYPOINTS" << std::endl;
+    for (size_t n = 0; n < 50; ++n) {
+      file << "45.763066 " << 3.1093255 + n * 1e-5 << " 1.0" << std::endl;
+    }
+  }
+
+  const auto wgs84Anchor = romea::core::makeGeodeticCoordinates(
+    45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3);
+
+  std::shared_future<void> future;
+  {
+    romea::core::PathMatching otherPathMatching(
+      std::string(TEST_DIR) + "/test_path_matching.cvs", wgs84Anchor, 10.0, 3.0);
+    future = otherPathMatching.loadPathAsync(filename.string(), wgs84Anchor);
+  }
+
+  // loading thread has been joined by the destructor
+  EXPECT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  std::filesystem::remove(filename);
+}
 
 //-----------------------------------------------------------------------------
 int main(int argc, char ** argv)
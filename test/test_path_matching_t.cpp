@@ -0,0 +1,164 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <string>
+#include <vector>
+
+// romea
+#include "../test/test_helper.h"
+#include "romea_core_path_matching/PathLoader.hpp"
+#include "romea_core_path_matching/PathMatching.hpp"
+#include "romea_core_path_matching/PathMatchingT.hpp"
+
+namespace
+{
+const double MAXIMAL_RESEARCH_RADIUS = 10.0;
+const double INTERPOLATION_WINDOW_LENGTH = 3.0;
+
+std::string pathFilename()
+{
+  return std::string(TEST_DIR) + "/test_path_matching.cvs";
+}
+
+romea::core::GeodeticCoordinates wgs84Anchor()
+{
+  return romea::core::makeGeodeticCoordinates(
+    45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3);
+}
+
+romea::core::Path2D loadTestPath()
+{
+  return romea::core::loadPath(pathFilename(), wgs84Anchor(), INTERPOLATION_WINDOW_LENGTH);
+}
+}  // namespace
+
+using LightPathMatching = romea::core::PathMatchingT<romea::core::Tracking<2>>;
+
+using FullPathMatching = romea::core::PathMatchingT<
+  romea::core::Tracking<2>,
+  romea::core::ConstantPrediction,
+  romea::core::PathMatchingDiagnostic>;
+
+//-----------------------------------------------------------------------------
+TEST(TestPathMatchingT, testTrackingSeedIsTheNearestMatchedPoint)
+{
+  std::vector<romea::core::PathMatchedPoint2D> matchedPoints(3);
+  matchedPoints[0].frenetPose.lateralDeviation = 2.0;
+  matchedPoints[0].sectionIndex = 0;
+  matchedPoints[1].frenetPose.lateralDeviation = -0.5;
+  matchedPoints[1].sectionIndex = 1;
+  matchedPoints[2].frenetPose.lateralDeviation = 1.0;
+  matchedPoints[2].sectionIndex = 2;
+
+  // first matched point is no longer the seed when another one is nearer
+  EXPECT_EQ(romea::core::selectTrackingSeed(matchedPoints).sectionIndex, 1u);
+
+  matchedPoints[1].frenetPose.lateralDeviation = -3.0;
+  EXPECT_EQ(romea::core::selectTrackingSeed(matchedPoints).sectionIndex, 2u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathMatchingT, testPathMatchingFailed)
+{
+  LightPathMatching pathMatching(loadTestPath(), MAXIMAL_RESEARCH_RADIUS);
+
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.x() = 10;
+  follower_pose.position.y() = 20;
+
+  auto pathMatchingPoints = pathMatching.match(
+    romea::core::durationFromSecond(10), follower_pose, follower_twist);
+
+  EXPECT_TRUE(pathMatchingPoints.empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathMatchingT, testSameResultsThanPathMatching)
+{
+  romea::core::PathMatching reference(
+    pathFilename(), wgs84Anchor(), MAXIMAL_RESEARCH_RADIUS, INTERPOLATION_WINDOW_LENGTH);
+  LightPathMatching pathMatching(loadTestPath(), MAXIMAL_RESEARCH_RADIUS);
+
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.y() = 1;
+
+  for (size_t n = 0; n < 50; ++n) {
+    auto stamp = romea::core::durationFromSecond(n * 0.1);
+    follower_pose.position.x() = 5 + n * 0.2;
+
+    auto expected = reference.match(stamp, follower_pose, follower_twist);
+    auto matchedPoints = pathMatching.match(stamp, follower_pose, follower_twist);
+
+    ASSERT_EQ(matchedPoints.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_DOUBLE_EQ(
+        matchedPoints[i].frenetPose.curvilinearAbscissa,
+        expected[i].frenetPose.curvilinearAbscissa);
+      EXPECT_DOUBLE_EQ(
+        matchedPoints[i].frenetPose.lateralDeviation,
+        expected[i].frenetPose.lateralDeviation);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathMatchingT, testWithDiagnostics)
+{
+  FullPathMatching pathMatching(
+    loadTestPath(), MAXIMAL_RESEARCH_RADIUS,
+    romea::core::ConstantPrediction(1.0),
+    romea::core::PathMatchingDiagnostic(pathFilename()));
+
+  romea::core::Twist2D follower_twist;
+  follower_twist.linearSpeeds.x() = 2.0;
+
+  romea::core::Pose2D follower_pose;
+  follower_pose.position.x() = 10;
+  follower_pose.position.y() = 1;
+
+  for (size_t n = 0; n <= 10; ++n) {
+    pathMatching.match(romea::core::durationFromSecond(n * 0.1), follower_pose, follower_twist);
+  }
+
+  auto report = pathMatching.getReport(romea::core::durationFromSecond(1.0));
+  EXPECT_STREQ(report.info["path_matching"].c_str(), "true");
+  EXPECT_STREQ(report.info["path_file_name"].c_str(), "test_path_matching.cvs");
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathMatchingT, testNoDiagnosticsReportIsEmpty)
+{
+  LightPathMatching pathMatching(loadTestPath(), MAXIMAL_RESEARCH_RADIUS);
+  auto report = pathMatching.getReport(romea::core::durationFromSecond(1.0));
+  EXPECT_TRUE(report.diagnostics.empty());
+  EXPECT_TRUE(report.info.empty());
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
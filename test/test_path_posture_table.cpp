@@ -0,0 +1,254 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PathPostureTable.hpp"
+
+namespace
+{
+romea::core::Path2D makeStraightPath(const size_t & numberOfPoints)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n < numberOfPoints; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(n * 0.5, n * 0.5));
+  }
+  return romea::core::Path2D({wayPoints}, 3.0);
+}
+
+romea::core::Path2D makeCircularPath(const double & radius)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n <= 300; ++n) {
+    double angle = n * M_PI / 300;
+    wayPoints.emplace_back(Eigen::Vector2d(radius * std::sin(angle), radius * (1 - std::cos(angle))));
+  }
+  return romea::core::Path2D({wayPoints}, 3.0);
+}
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testStraightLine)
+{
+  romea::core::PathPostureTable table(makeStraightPath(100), 0.1, 3.0);
+
+  EXPECT_NEAR(table.getMaximalCurvilinearAbscissa(), 99 * 0.5 * std::sqrt(2.), 0.1);
+
+  auto posture = table.lookup(10 * std::sqrt(2.));
+  EXPECT_NEAR(posture.position.x(), 10, 1e-6);
+  EXPECT_NEAR(posture.position.y(), 10, 1e-6);
+  EXPECT_NEAR(posture.course, M_PI_4, 1e-6);
+  EXPECT_NEAR(posture.curvature, 0, 1e-6);
+  EXPECT_NEAR(posture.dotCurvature, 0, 1e-6);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testCircle)
+{
+  const double radius = 10;
+  romea::core::PathPostureTable table(makeCircularPath(radius), 0.1, 1.0);
+
+  romea::core::PathPostures2D postures;
+  table.lookup(2.0, 0.5, 50, postures);
+  ASSERT_EQ(postures.size(), 50);
+
+  for (size_t n = 0; n < postures.size(); ++n) {
+    double angle = (2.0 + n * 0.5) / radius;
+    EXPECT_NEAR(postures.x[n], radius * std::sin(angle), 0.01);
+    EXPECT_NEAR(postures.y[n], radius * (1 - std::cos(angle)), 0.01);
+    EXPECT_NEAR(postures.course[n], angle, 0.01);
+    EXPECT_NEAR(postures.curvature[n], 1 / radius, 0.005);
+    EXPECT_NEAR(postures.dotCurvature[n], 0, 0.005);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testPosturesAreNotMixedAcrossCusps)
+{
+  // forward then backward on the same line, the cusp is located at 10 m
+  std::vector<romea::core::PathWayPoint2D> forward;
+  std::vector<romea::core::PathWayPoint2D> backward;
+  for (size_t n = 0; n <= 20; ++n) {
+    forward.emplace_back(Eigen::Vector2d(n * 0.5, 0.), 1.0);
+    backward.emplace_back(Eigen::Vector2d(10. - n * 0.5, 0.), -1.0);
+  }
+  romea::core::PathPostureTable table(
+    romea::core::Path2D({forward, backward}, 3.0), 0.1, 3.0);
+
+  EXPECT_NEAR(table.getMaximalCurvilinearAbscissa(), 20., 0.1);
+  for (double abscissa = 0.5; abscissa < 19.5; abscissa += 0.05) {
+    auto posture = table.lookup(abscissa);
+    const double expectedCourse = abscissa <= 10. ? 0. : M_PI;
+    EXPECT_NEAR(std::remainder(posture.course - expectedCourse, 2 * M_PI), 0, 1e-3);
+    EXPECT_NEAR(posture.curvature, 0, 1e-3);
+    EXPECT_NEAR(posture.position.y(), 0, 1e-6);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testSectionUpdateMovesFollowingSections)
+{
+  std::vector<romea::core::PathWayPoint2D> first;
+  std::vector<romea::core::PathWayPoint2D> second;
+  for (size_t n = 0; n <= 20; ++n) {
+    first.emplace_back(Eigen::Vector2d(n * 0.5, 0.), 1.0);
+    second.emplace_back(Eigen::Vector2d(10., n * 0.5), 1.0);
+  }
+  romea::core::PathPostureTable table(romea::core::Path2D({first, second}, 3.0), 0.1, 3.0);
+
+  // end of the first section is moved 1 m to the left from 5 m, it gets longer
+  for (size_t n = 10; n <= 20; ++n) {
+    first[n].position.y() = 1.0;
+  }
+  const romea::core::Path2D splicedPath({first, second}, 3.0);
+  const double lengthOffset = std::hypot(0.5, 1.0) - 0.5;
+  table.update(splicedPath, 0, 5.0, lengthOffset);
+
+  romea::core::PathPostureTable expectedTable(splicedPath, 0.1, 3.0);
+  EXPECT_NEAR(
+    table.getMaximalCurvilinearAbscissa(), expectedTable.getMaximalCurvilinearAbscissa(), 1e-9);
+
+  const double secondSectionAbscissa = 10. + lengthOffset;
+  for (double abscissa = 0; abscissa < table.getMaximalCurvilinearAbscissa(); abscissa += 0.07) {
+    if (std::abs(abscissa - secondSectionAbscissa) < 0.2) {
+      continue;
+    }
+    auto posture = table.lookup(abscissa);
+    auto expectedPosture = expectedTable.lookup(abscissa);
+    EXPECT_NEAR((posture.position - expectedPosture.position).norm(), 0, 1e-6);
+    EXPECT_NEAR(std::remainder(posture.course - expectedPosture.course, 2 * M_PI), 0, 1e-6);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testLookupIsClampedToPathExtremities)
+{
+  romea::core::PathPostureTable table(makeStraightPath(10), 0.1, 3.0);
+
+  std::vector<double> abscissas = {-10., 1000.};
+  romea::core::PathPostures2D postures;
+  table.lookup(abscissas, postures);
+
+  EXPECT_NEAR(postures.x[0], 0, 1e-6);
+  EXPECT_NEAR(postures.y[0], 0, 1e-6);
+  EXPECT_NEAR(postures.x[1], 4.5, 0.1);
+  EXPECT_NEAR(postures.y[1], 4.5, 0.1);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testEmptyTable)
+{
+  romea::core::PathPostureTable table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_THROW(table.lookup(0.), std::runtime_error);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testCompactTableErrorIsBounded)
+{
+  const auto path = makeCircularPath(10);
+  romea::core::PathPostureTable table(path, 0.1, 1.0);
+  romea::core::PathPostureTable compactTable(path, 0.1, 1.0);
+  compactTable.compact();
+
+  EXPECT_TRUE(compactTable.isCompact());
+  EXPECT_EQ(compactTable.getSamples().size(), 0u);
+  EXPECT_DOUBLE_EQ(
+    compactTable.getMaximalCurvilinearAbscissa(), table.getMaximalCurvilinearAbscissa());
+  EXPECT_LT(compactTable.getMemoryUsage() * 3.5, table.getMemoryUsage());
+
+  double maximalCurvature = 0;
+  double maximalDotCurvature = 0;
+  for (size_t n = 0; n < table.getSamples().size(); ++n) {
+    maximalCurvature = std::max(maximalCurvature, std::abs(table.getSamples().curvature[n]));
+    maximalDotCurvature = std::max(
+      maximalDotCurvature, std::abs(table.getSamples().dotCurvature[n]));
+  }
+
+  romea::core::PathPostures2D postures;
+  romea::core::PathPostures2D compactPostures;
+  table.lookup(0., 0.013, 2400, postures);
+  compactTable.lookup(0., 0.013, 2400, compactPostures);
+  for (size_t n = 0; n < postures.size(); ++n) {
+    EXPECT_NEAR(compactPostures.x[n], postures.x[n], 0.0005 + 1e-9);
+    EXPECT_NEAR(compactPostures.y[n], postures.y[n], 0.0005 + 1e-9);
+    EXPECT_NEAR(
+      std::remainder(compactPostures.course[n] - postures.course[n], 2 * M_PI), 0, 4.8e-5);
+    EXPECT_NEAR(compactPostures.curvature[n], postures.curvature[n], maximalCurvature / 65534);
+    EXPECT_NEAR(
+      compactPostures.dotCurvature[n], postures.dotCurvature[n], maximalDotCurvature / 65534);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testTableWithGapIsNotCompacted)
+{
+  std::vector<romea::core::PathWayPoint2D> first;
+  std::vector<romea::core::PathWayPoint2D> second;
+  for (size_t n = 0; n < 20; ++n) {
+    first.emplace_back(Eigen::Vector2d(n * 0.5, 0.));
+    second.emplace_back(Eigen::Vector2d(100 + n * 0.5, 0.));
+  }
+
+  romea::core::PathPostureTable table(romea::core::Path2D({first, second}, 3.0), 0.1, 3.0);
+  const auto samples = table.getSamples();
+  const size_t memoryUsage = table.getMemoryUsage();
+
+  EXPECT_FALSE(table.compact());
+  EXPECT_FALSE(table.isCompact());
+  EXPECT_EQ(table.getMemoryUsage(), memoryUsage);
+  ASSERT_EQ(table.getSamples().size(), samples.size());
+  for (size_t n = 0; n < samples.size(); ++n) {
+    EXPECT_EQ(table.getSamples().x[n], samples.x[n]);
+    EXPECT_EQ(table.getSamples().y[n], samples.y[n]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPathPostureTable, testCompactTableUpdate)
+{
+  romea::core::PathPostureTable table(makeStraightPath(100), 0.1, 3.0);
+  romea::core::PathPostureTable compactTable(makeStraightPath(100), 0.1, 3.0);
+  compactTable.compact();
+
+  const auto path = makeCircularPath(10);
+  table.update(path, 5.);
+  compactTable.update(path, 5.);
+  EXPECT_TRUE(compactTable.isCompact());
+  EXPECT_DOUBLE_EQ(
+    compactTable.getMaximalCurvilinearAbscissa(), table.getMaximalCurvilinearAbscissa());
+
+  for (double abscissa = 0; abscissa < table.getMaximalCurvilinearAbscissa(); abscissa += 0.7) {
+    auto posture = table.lookup(abscissa);
+    auto compactPosture = compactTable.lookup(abscissa);
+    EXPECT_NEAR((compactPosture.position - posture.position).norm(), 0, 0.001);
+    EXPECT_NEAR(std::remainder(compactPosture.course - posture.course, 2 * M_PI), 0, 1e-4);
+    EXPECT_NEAR(compactPosture.curvature, posture.curvature, 1e-4);
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
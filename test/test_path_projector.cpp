@@ -0,0 +1,173 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PathProjector.hpp"
+
+class TestPathProjector : public ::testing::Test
+{
+public:
+  TestPathProjector()
+  : path(makeWayPoints(), 3.0),
+    pathIndex(path),
+    abscissaIndex(path),
+    projector(path, pathIndex, abscissaIndex)
+  {
+  }
+
+  static std::vector<std::vector<romea::core::PathWayPoint2D>> makeWayPoints()
+  {
+    std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints(2);
+    for (size_t n = 0; n <= 100; ++n) {
+      wayPoints[0].emplace_back(Eigen::Vector2d(0.2 * n, 0), 1.0);
+      wayPoints[1].emplace_back(Eigen::Vector2d(20, 0.2 * n), 1.0);
+    }
+    return wayPoints;
+  }
+
+  // positions moving along the path with a random lateral noise
+  static std::vector<Eigen::Vector2d> makePoints(const size_t & size)
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+
+    std::vector<Eigen::Vector2d> points;
+    for (size_t n = 0; n < size; ++n) {
+      double s = 40.0 * n / size;
+      if (s < 20) {
+        points.emplace_back(s, noise(generator));
+      } else {
+        points.emplace_back(20 + noise(generator), s - 20);
+      }
+    }
+    return points;
+  }
+
+  romea::core::Path2D path;
+  romea::core::CoarsePathIndex pathIndex;
+  romea::core::PathAbscissaIndex abscissaIndex;
+  romea::core::PathProjector projector;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathProjector, projectionMatchesExhaustiveResearch)
+{
+  auto points = makePoints(5000);
+  romea::core::PathFrenetCoordinates2D coordinates;
+  projector.project(points, 5.0, coordinates);
+
+  ASSERT_EQ(coordinates.size(), points.size());
+  for (size_t n = 0; n < points.size(); ++n) {
+    // exhaustive research on all way point segments
+    double lateralDeviation = std::numeric_limits<double>::max();
+    double curvilinearAbscissa = 0;
+    double sectionInitialAbscissa = 0;
+    for (const auto & section : path.getSections()) {
+      const auto & X = section.getX();
+      const auto & Y = section.getY();
+      for (size_t i = 0; i + 1 < X.size(); ++i) {
+        Eigen::Vector2d a(X[i], Y[i]);
+        Eigen::Vector2d b(X[i + 1], Y[i + 1]);
+        double t = std::clamp((points[n] - a).dot(b - a) / (b - a).squaredNorm(), 0., 1.);
+        double distance = (points[n] - a - t * (b - a)).norm();
+        if (distance < lateralDeviation) {
+          lateralDeviation = distance;
+          curvilinearAbscissa = sectionInitialAbscissa + (i + t) * (b - a).norm();
+        }
+      }
+      sectionInitialAbscissa += (X.size() - 1) * 0.2;
+    }
+
+    EXPECT_NEAR(std::abs(coordinates.lateralDeviation[n]), lateralDeviation, 1e-9);
+    EXPECT_NEAR(coordinates.curvilinearAbscissa[n], curvilinearAbscissa, 1e-9);
+  }
+
+  EXPECT_EQ(coordinates.sectionIndex.front(), 0u);
+  EXPECT_EQ(coordinates.sectionIndex.back(), 1u);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathProjector, lateralDeviationIsPositiveOnTheLeft)
+{
+  romea::core::PathFrenetCoordinates2D coordinates;
+  projector.project({{5, 1}, {5, -1}, {19, 5}}, 5.0, coordinates);
+
+  EXPECT_DOUBLE_EQ(coordinates.lateralDeviation[0], 1.0);
+  EXPECT_DOUBLE_EQ(coordinates.lateralDeviation[1], -1.0);
+  EXPECT_DOUBLE_EQ(coordinates.lateralDeviation[2], 1.0);
+  EXPECT_NEAR(coordinates.curvilinearAbscissa[2], 25.0, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathProjector, pointsOutOfResearchRadiusAreNotProjected)
+{
+  romea::core::PathFrenetCoordinates2D coordinates;
+  projector.project({{5, 1}, {5, 10}, {5, 1}}, 5.0, coordinates);
+
+  EXPECT_DOUBLE_EQ(coordinates.curvilinearAbscissa[0], 5.0);
+  EXPECT_TRUE(std::isnan(coordinates.curvilinearAbscissa[1]));
+  EXPECT_TRUE(std::isnan(coordinates.lateralDeviation[1]));
+  EXPECT_EQ(
+    coordinates.sectionIndex[1],
+    romea::core::PathFrenetCoordinates2D::INVALID_SECTION_INDEX);
+  EXPECT_DOUBLE_EQ(coordinates.curvilinearAbscissa[2], 5.0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestPathProjector, parallelProjectionGivesSameResults)
+{
+  auto points = makePoints(20000);
+  romea::core::PathFrenetCoordinates2D sequentialCoordinates;
+  romea::core::PathFrenetCoordinates2D parallelCoordinates;
+  projector.project(points, 5.0, sequentialCoordinates);
+
+  // executor supplied by the caller, tasks run on their own threads here
+  size_t numberOfExecutedTasks = 0;
+  auto executor = [&numberOfExecutedTasks](
+    size_t numberOfTasks, const std::function<void(size_t)> & task) {
+      std::vector<std::thread> threads;
+      for (size_t n = 0; n < numberOfTasks; ++n) {
+        threads.emplace_back(task, n);
+      }
+      for (auto & thread : threads) {
+        thread.join();
+      }
+      numberOfExecutedTasks += numberOfTasks;
+    };
+  projector.project(points, 5.0, parallelCoordinates, executor, 4);
+  EXPECT_EQ(numberOfExecutedTasks, 4u);
+
+  ASSERT_EQ(parallelCoordinates.size(), points.size());
+  for (size_t n = 0; n < points.size(); ++n) {
+    EXPECT_NEAR(
+      sequentialCoordinates.curvilinearAbscissa[n],
+      parallelCoordinates.curvilinearAbscissa[n], 1e-9);
+    EXPECT_NEAR(
+      std::abs(sequentialCoordinates.lateralDeviation[n]),
+      std::abs(parallelCoordinates.lateralDeviation[n]), 1e-9);
+  }
+}
@@ -0,0 +1,130 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cmath>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/PoseChangeDetector.hpp"
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseChangeDetector, disabledDetectorAlwaysReportsChanges)
+{
+  romea::core::PoseChangeDetector detector;
+  romea::core::Pose2D pose;
+  romea::core::Twist2D twist;
+  detector.setReference(pose, twist, 0.);
+  EXPECT_FALSE(detector.isEnabled());
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseChangeDetector, changesAreMeasuredFromReference)
+{
+  romea::core::PoseChangeDetector detector({0.05, 0.01, 0.1, 0.05});
+  romea::core::Pose2D pose;
+  romea::core::Twist2D twist;
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+
+  detector.setReference(pose, twist, 0.);
+  EXPECT_FALSE(detector.hasChanged(pose, twist, 0.));
+
+  // creeping vehicle is caught once its displacement from reference exceeds threshold
+  pose.position.x() = 0.04;
+  EXPECT_FALSE(detector.hasChanged(pose, twist, 0.));
+  pose.position.x() = 0.06;
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+
+  pose.position.x() = 0;
+  pose.yaw = 2 * M_PI + 0.005;
+  EXPECT_FALSE(detector.hasChanged(pose, twist, 0.));
+  pose.yaw = -0.02;
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+
+  pose.yaw = 0;
+  twist.linearSpeeds.x() = 0.2;
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+  twist.linearSpeeds.x() = 0;
+  twist.angularSpeed = 0.1;
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+
+  // research predicted further ahead is not the one of the reference
+  twist.angularSpeed = 0;
+  EXPECT_FALSE(detector.hasChanged(pose, twist, 0.));
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.5));
+  detector.setReference(pose, twist, 0.5);
+  EXPECT_FALSE(detector.hasChanged(pose, twist, 0.5));
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.));
+
+  detector.reset();
+  EXPECT_TRUE(detector.hasChanged(pose, twist, 0.5));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseChangeDetector, negativeThresholds)
+{
+  EXPECT_THROW(romea::core::PoseChangeDetector({-0.1, 0, 0, 0}), std::invalid_argument);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseChangeDetector, extrapolateMatchedPoint)
+{
+  std::vector<romea::core::PathWayPoint2D> wayPoints;
+  for (size_t n = 0; n <= 10; ++n) {
+    wayPoints.emplace_back(Eigen::Vector2d(1.0, n * 0.5));
+  }
+  const romea::core::Path2D path({wayPoints}, 3.0);
+
+  romea::core::PathMatchedPoint2D matchedPoint;
+  matchedPoint.pathPosture.position = Eigen::Vector2d(1.0, 2.0);
+  matchedPoint.pathPosture.course = M_PI_2;
+  matchedPoint.frenetPose.curvilinearAbscissa = 10.0;
+  matchedPoint.frenetPose.lateralDeviation = 0.2;
+  matchedPoint.frenetPose.courseDeviation = 0.0;
+  matchedPoint.sectionIndex = 0;
+  matchedPoint.curveIndex = 4;
+
+  romea::core::Pose2D pose;
+  pose.position = Eigen::Vector2d(0.7, 2.05);
+  pose.yaw = M_PI_2 + 0.1;
+
+  auto extrapolatedPoint = romea::core::extrapolateMatchedPoint(
+    path.getSection(0), matchedPoint, pose);
+  ASSERT_TRUE(extrapolatedPoint.has_value());
+  EXPECT_NEAR(extrapolatedPoint->pathPosture.position.x(), 1.0, 1e-9);
+  EXPECT_NEAR(extrapolatedPoint->pathPosture.position.y(), 2.05, 1e-9);
+  EXPECT_NEAR(extrapolatedPoint->frenetPose.curvilinearAbscissa, 10.05, 1e-9);
+  EXPECT_NEAR(extrapolatedPoint->frenetPose.lateralDeviation, 0.3, 1e-9);
+  EXPECT_NEAR(extrapolatedPoint->frenetPose.courseDeviation, 0.1, 1e-9);
+
+  // moved past the neighbouring way points, curve of the matched point is left
+  pose.position.y() = 2.6;
+  EXPECT_FALSE(romea::core::extrapolateMatchedPoint(
+      path.getSection(0), matchedPoint, pose).has_value());
+  pose.position.y() = 1.4;
+  EXPECT_FALSE(romea::core::extrapolateMatchedPoint(
+      path.getSection(0), matchedPoint, pose).has_value());
+
+  // no curve beyond the last way point
+  matchedPoint.pathPosture.position.y() = 5.0;
+  matchedPoint.curveIndex = 10;
+  pose.position.y() = 5.1;
+  EXPECT_FALSE(romea::core::extrapolateMatchedPoint(
+      path.getSection(0), matchedPoint, pose).has_value());
+}
@@ -0,0 +1,160 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <future>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+#include "romea_core_path_matching/PoseStreamPipeline.hpp"
+
+namespace
+{
+
+romea::core::Pose2D makePose(const double & x)
+{
+  romea::core::Pose2D pose;
+  pose.position.x() = x;
+  return pose;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseStreamPipeline, testLatestFollowerPoseWins)
+{
+  std::promise<void> gate;
+  std::shared_future<void> gateOpened = gate.get_future().share();
+  std::promise<void> firstPose;
+  std::vector<double> matchedStamps;
+
+  romea::core::PoseStreamPipeline pipeline(
+    nullptr,
+    [&](const romea::core::PoseSample & followerPose) {
+      if (matchedStamps.empty()) {
+        firstPose.set_value();
+        gateOpened.wait();
+      }
+      matchedStamps.push_back(romea::core::durationToSecond(followerPose.stamp));
+    });
+
+  // matcher is stuck on the first pose while the stream goes on
+  pipeline.pushFollowerPose(romea::core::durationFromSecond(0), makePose(0), {});
+  firstPose.get_future().wait();
+  for (size_t n = 1; n <= 100; ++n) {
+    pipeline.pushFollowerPose(romea::core::durationFromSecond(n * 0.1), makePose(n), {});
+  }
+  gate.set_value();
+  pipeline.flush();
+
+  ASSERT_EQ(matchedStamps.size(), 2u);
+  EXPECT_DOUBLE_EQ(matchedStamps[0], 0.);
+  EXPECT_DOUBLE_EQ(matchedStamps[1], 10.);
+  EXPECT_EQ(pipeline.getNumberOfDroppedFollowerPoses(), 99u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseStreamPipeline, testLeaderPosesAreBatchedInOrder)
+{
+  std::promise<void> gate;
+  std::shared_future<void> gateOpened = gate.get_future().share();
+  std::promise<void> firstPose;
+  std::vector<size_t> batchSizes;
+  std::vector<double> leaderPositions;
+  size_t numberOfMatches = 0;
+
+  romea::core::PoseStreamPipeline pipeline(
+    [&](const std::vector<romea::core::PoseSample> & leaderPoses) {
+      batchSizes.push_back(leaderPoses.size());
+      for (const auto & leaderPose : leaderPoses) {
+        leaderPositions.push_back(leaderPose.pose.position.x());
+      }
+    },
+    [&](const romea::core::PoseSample &) {
+      if (numberOfMatches++ == 0) {
+        firstPose.set_value();
+        gateOpened.wait();
+      }
+    });
+
+  pipeline.pushFollowerPose(romea::core::durationFromSecond(0), makePose(0), {});
+  firstPose.get_future().wait();
+  for (size_t n = 0; n < 50; ++n) {
+    pipeline.pushLeaderPose(romea::core::durationFromSecond(n * 0.1), makePose(n), {});
+  }
+  pipeline.pushFollowerPose(romea::core::durationFromSecond(5), makePose(0), {});
+  gate.set_value();
+  pipeline.flush();
+
+  ASSERT_EQ(batchSizes.size(), 1u);
+  EXPECT_EQ(batchSizes[0], 50u);
+  ASSERT_EQ(leaderPositions.size(), 50u);
+  for (size_t n = 0; n < 50; ++n) {
+    EXPECT_DOUBLE_EQ(leaderPositions[n], n);
+  }
+  EXPECT_EQ(numberOfMatches, 2u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseStreamPipeline, testHandlerErrorIsRethrownByFlush)
+{
+  romea::core::PoseStreamPipeline pipeline(
+    nullptr,
+    [](const romea::core::PoseSample &) {
+      throw std::runtime_error("matching failed");
+    });
+
+  EXPECT_THROW(
+    pipeline.pushLeaderPose(romea::core::durationFromSecond(0), makePose(0), {}),
+    std::logic_error);
+
+  pipeline.pushFollowerPose(romea::core::durationFromSecond(0), makePose(0), {});
+  EXPECT_THROW(pipeline.flush(), std::runtime_error);
+  EXPECT_NO_THROW(pipeline.flush());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestPoseStreamPipeline, testOnTheFlyPathMatching)
+{
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1);
+  std::vector<std::optional<romea::core::PathMatchedPoint2D>> matchedPoints;
+  auto pipeline = romea::core::makePoseStreamPipeline(
+    pathMatching,
+    [&](const romea::core::Duration &,
+    const std::optional<romea::core::PathMatchedPoint2D> & matchedPoint) {
+      matchedPoints.push_back(matchedPoint);
+    });
+
+  romea::core::Twist2D twist;
+  twist.linearSpeeds.x() = 2.0;
+  for (size_t n = 0; n < 100; ++n) {
+    pipeline->pushLeaderPose(romea::core::durationFromSecond(n * 0.1), makePose(n * 0.2), twist);
+  }
+
+  romea::core::Pose2D followerPose = makePose(10);
+  followerPose.position.y() = 1;
+  pipeline->pushFollowerPose(romea::core::durationFromSecond(10), followerPose, twist);
+  pipeline->flush();
+
+  ASSERT_FALSE(matchedPoints.empty());
+  EXPECT_TRUE(matchedPoints.back().has_value());
+}
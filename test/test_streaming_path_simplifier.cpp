@@ -0,0 +1,122 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// romea
+#include "romea_core_path_matching/StreamingPathSimplifier.hpp"
+
+namespace
+{
+double distanceToPolyline(
+  const Eigen::Vector2d & point,
+  const std::vector<Eigen::Vector2d> & polyline)
+{
+  double distance = std::numeric_limits<double>::max();
+  for (size_t n = 1; n < polyline.size(); ++n) {
+    Eigen::Vector2d segment = polyline[n] - polyline[n - 1];
+    double t = std::clamp(
+      (point - polyline[n - 1]).dot(segment) / segment.squaredNorm(), 0., 1.);
+    distance = std::min(distance, (point - polyline[n - 1] - t * segment).norm());
+  }
+  return distance;
+}
+
+std::vector<Eigen::Vector2d> simplify(
+  romea::core::StreamingPathSimplifier & simplifier,
+  const std::vector<Eigen::Vector2d> & points)
+{
+  std::vector<Eigen::Vector2d> keptPoints;
+  for (const auto & point : points) {
+    if (auto keptPoint = simplifier.update(point)) {
+      keptPoints.push_back(*keptPoint);
+    }
+  }
+  return keptPoints;
+}
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestStreamingPathSimplifier, testStraightLine)
+{
+  romea::core::StreamingPathSimplifier simplifier(0.01, 1.5);
+
+  std::vector<Eigen::Vector2d> points;
+  for (size_t n = 0; n <= 1000; ++n) {
+    points.emplace_back(n * 0.1, 0);
+  }
+
+  auto keptPoints = simplify(simplifier, points);
+  EXPECT_LE(keptPoints.size(), 80);
+  EXPECT_DOUBLE_EQ(keptPoints.front().x(), 0);
+  for (size_t n = 1; n < keptPoints.size(); ++n) {
+    EXPECT_LE((keptPoints[n] - keptPoints[n - 1]).norm(), 1.5 + 1e-9);
+  }
+  EXPECT_LE((points.back() - keptPoints.back()).norm(), 1.5 + 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestStreamingPathSimplifier, testLateralErrorIsBounded)
+{
+  const double maximalLateralError = 0.02;
+  romea::core::StreamingPathSimplifier simplifier(maximalLateralError, 1.5);
+
+  std::vector<Eigen::Vector2d> points;
+  for (size_t n = 0; n <= 2000; ++n) {
+    double angle = n * 0.01;
+    points.emplace_back(5 * std::cos(angle) + 0.01 * n, 5 * std::sin(angle));
+  }
+
+  auto keptPoints = simplify(simplifier, points);
+  EXPECT_LT(keptPoints.size(), points.size() / 4);
+
+  std::vector<Eigen::Vector2d> polyline = keptPoints;
+  polyline.insert(
+    polyline.end(),
+    simplifier.getPendingPoints().begin(),
+    simplifier.getPendingPoints().end());
+
+  for (const auto & point : points) {
+    EXPECT_LE(distanceToPolyline(point, polyline), maximalLateralError + 1e-9);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestStreamingPathSimplifier, testLongStepsAreAllKept)
+{
+  romea::core::StreamingPathSimplifier simplifier(0.01, 1.0);
+
+  std::vector<Eigen::Vector2d> points;
+  for (size_t n = 0; n <= 10; ++n) {
+    points.emplace_back(n * 2.0, 0);
+  }
+
+  auto keptPoints = simplify(simplifier, points);
+  EXPECT_EQ(keptPoints.size(), points.size());
+  EXPECT_TRUE(simplifier.getPendingPoints().empty());
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,447 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// romea
+#include "../test/test_helper.h"
+#include "romea_core_path_matching/OnTheFlyPathMatching.hpp"
+#include "romea_core_path_matching/PathMatching.hpp"
+#include "romea_core_path_matching/PathProjector.hpp"
+
+// Soak test of path matching, sizes and thresholds can be overridden by environment:
+//   ROMEA_PATH_MATCHING_STRESS_ITERATIONS      number of match calls per scenario
+//   ROMEA_PATH_MATCHING_STRESS_MAX_LATENCY_US  99th percentile of match latency
+//   ROMEA_PATH_MATCHING_STRESS_MAX_RSS_GROWTH  resident memory growth in bytes
+
+namespace
+{
+
+#if defined(__SANITIZE_ADDRESS__) || defined(ROMEA_PATH_MATCHING_SANITIZERS)
+constexpr bool SANITIZED = true;
+#else
+constexpr bool SANITIZED = false;
+#endif
+
+const size_t LATENCY_WINDOW_SIZE = 10000;
+const size_t ON_THE_FLY_SESSION_SIZE = 5000;
+
+size_t environmentValue(const char * name, const size_t & defaultValue)
+{
+  const char * value = std::getenv(name);
+  return value != nullptr ? std::stoul(value) : defaultValue;
+}
+
+size_t iterations()
+{
+  return environmentValue("ROMEA_PATH_MATCHING_STRESS_ITERATIONS", 100000);
+}
+
+double maximalLatency()
+{
+  // sanitizers slow down each call by an order of magnitude
+  return environmentValue("ROMEA_PATH_MATCHING_STRESS_MAX_LATENCY_US", 2000) * (SANITIZED ? 20 : 1);
+}
+
+size_t maximalResidentSetSizeGrowth()
+{
+  return environmentValue("ROMEA_PATH_MATCHING_STRESS_MAX_RSS_GROWTH", 32 * 1024 * 1024);
+}
+
+size_t residentSetSize()
+{
+  std::ifstream statm("/proc/self/statm");
+  size_t size = 0;
+  size_t resident = 0;
+  statm >> size >> resident;
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Mean and 99th percentile of call latency over consecutive windows of calls, thread
+// CPU time is measured so preemption by other threads does not count
+class LatencyMonitor
+{
+public:
+  struct Window
+  {
+    double mean;
+    double percentile99;
+  };
+
+  template<typename Function>
+  auto measure(Function && function)
+  {
+    double start = threadTime_();
+    auto result = function();
+    record_(threadTime_() - start);
+    return result;
+  }
+
+  void check(const double & maximalLatency)
+  {
+    if (!latencies_.empty()) {
+      closeWindow_();
+    }
+
+    ASSERT_FALSE(windows_.empty());
+    for (const auto & window : windows_) {
+      EXPECT_LE(window.percentile99, maximalLatency);
+    }
+    // latency must not drift as the test goes on
+    EXPECT_LE(windows_.back().mean, 3 * windows_.front().mean + 20);
+  }
+
+private:
+  static double threadTime_()
+  {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec * 1e6 + time.tv_nsec * 1e-3;
+  }
+
+  void record_(const double & latency)
+  {
+    latencies_.push_back(latency);
+    if (latencies_.size() == LATENCY_WINDOW_SIZE) {
+      closeWindow_();
+    }
+  }
+
+  void closeWindow_()
+  {
+    double mean = 0;
+    for (const double & l : latencies_) {
+      mean += l;
+    }
+    auto percentile = latencies_.begin() + latencies_.size() * 99 / 100;
+    std::nth_element(latencies_.begin(), percentile, latencies_.end());
+    windows_.push_back({mean / latencies_.size(), *percentile});
+    latencies_.clear();
+  }
+
+  std::vector<double> latencies_;
+  std::vector<Window> windows_;
+};
+
+// Random walk of curvature and speed, loops are produced by long constant turns
+class MotionGenerator
+{
+public:
+  explicit MotionGenerator(const unsigned int & seed)
+  : generator_(seed),
+    uniform_(0., 1.),
+    curvature_(0),
+    speed_(2.0),
+    loopDuration_(0)
+  {
+  }
+
+  void step(const double & dt)
+  {
+    if (loopDuration_ > 0) {
+      loopDuration_ -= dt;
+    } else if (uniform_(generator_) < 0.0005) {
+      curvature_ = uniform_(generator_) < 0.5 ? -0.25 : 0.25;
+      loopDuration_ = 2 * M_PI / (0.25 * speed_);
+    } else {
+      curvature_ = std::clamp(curvature_ + (uniform_(generator_) - 0.5) * dt, -0.2, 0.2);
+      speed_ = std::clamp(speed_ + (uniform_(generator_) - 0.5) * dt, 0.5, 3.0);
+    }
+
+    pose.yaw += speed_ * curvature_ * dt;
+    pose.position.x() += speed_ * std::cos(pose.yaw) * dt;
+    pose.position.y() += speed_ * std::sin(pose.yaw) * dt;
+    twist.linearSpeeds.x() = speed_;
+    twist.angularSpeed = speed_ * curvature_;
+  }
+
+  romea::core::Pose2D pose;
+  romea::core::Twist2D twist;
+
+private:
+  std::mt19937 generator_;
+  std::uniform_real_distribution<double> uniform_;
+  double curvature_;
+  double speed_;
+  double loopDuration_;
+};
+
+// Follower drives on leader trail with a varying delay, delay growing faster than
+// leader motion makes the follower reverse
+class FollowerGenerator
+{
+public:
+  explicit FollowerGenerator(const unsigned int & seed)
+  : generator_(seed),
+    uniform_(0., 1.),
+    delay_(30),
+    delayRate_(0)
+  {
+  }
+
+  bool step(const MotionGenerator & leader, const double & dt)
+  {
+    trail_.push_back(leader.pose);
+    if (trail_.size() > MAXIMAL_DELAY + 1) {
+      trail_.pop_front();
+    }
+
+    if (uniform_(generator_) < 0.002) {
+      delayRate_ = uniform_(generator_) < 0.3 ? 2 : 0;
+    }
+    delay_ = std::clamp<size_t>(delay_ + delayRate_, 10, MAXIMAL_DELAY);
+    if (trail_.size() <= delay_) {
+      return false;
+    }
+
+    const auto & trailPose = trail_[trail_.size() - 1 - delay_];
+    Eigen::Vector2d normal(-std::sin(trailPose.yaw), std::cos(trailPose.yaw));
+    Eigen::Vector2d position = trailPose.position + normal * 0.4 * (uniform_(generator_) - 0.5);
+    twist.linearSpeeds.x() = (delayRate_ > 1 ? -1 : 1) * (position - pose.position).norm() / dt;
+    pose.position = position;
+    pose.yaw = trailPose.yaw;
+    return true;
+  }
+
+  romea::core::Pose2D pose;
+  romea::core::Twist2D twist;
+
+private:
+  static constexpr size_t MAXIMAL_DELAY = 200;
+
+  std::mt19937 generator_;
+  std::uniform_real_distribution<double> uniform_;
+  std::deque<romea::core::Pose2D> trail_;
+  size_t delay_;
+  size_t delayRate_;
+};
+
+// Leader and follower session on a fresh on the fly path, returns a checksum of results
+double runOnTheFlySession(
+  const unsigned int & seed,
+  const size_t & size,
+  LatencyMonitor * latencyMonitor)
+{
+  const double dt = 0.1;
+  romea::core::OnTheFlyPathMatching pathMatching(1.0, 10.0, 3.0, 0.1, 0.1, seed % 2 ? 0.02 : 0.);
+  MotionGenerator leader(seed);
+  FollowerGenerator follower(seed + 1);
+
+  double checksum = 0;
+  for (size_t n = 0; n < size; ++n) {
+    auto stamp = romea::core::durationFromSecond(n * dt);
+    leader.step(dt);
+    pathMatching.updatePath(stamp, leader.pose, leader.twist);
+    if (!follower.step(leader, dt)) {
+      continue;
+    }
+
+    auto match = [&]() {
+        return pathMatching.match(stamp, follower.pose, follower.twist);
+      };
+    auto matchedPoint = latencyMonitor ? latencyMonitor->measure(match) : match();
+
+    if (matchedPoint.has_value()) {
+      checksum += matchedPoint->frenetPose.curvilinearAbscissa;
+      checksum += pathMatching.getLeaderSpeed(*matchedPoint).value_or(0);
+    }
+  }
+  pathMatching.getReport(romea::core::durationFromSecond(size * dt));
+  return checksum;
+}
+
+// Three laps of a lemniscate, the path crosses itself and laps overlap
+std::vector<std::vector<romea::core::PathWayPoint2D>> makeLemniscateWayPoints()
+{
+  std::vector<std::vector<romea::core::PathWayPoint2D>> wayPoints(1);
+  const double a = 30;
+  for (double t = 0; t < 6 * M_PI; t += 0.006) {
+    double d = 1 + std::sin(t) * std::sin(t);
+    wayPoints[0].emplace_back(
+      Eigen::Vector2d(a * std::cos(t) / d, a * std::sin(t) * std::cos(t) / d), 1.0);
+  }
+  return wayPoints;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestStress, onTheFlyPathMatchingMemoryAndLatencyAreBounded)
+{
+  const size_t numberOfSessions = std::max<size_t>(2, iterations() / ON_THE_FLY_SESSION_SIZE);
+
+  LatencyMonitor latencyMonitor;
+  size_t initialResidentSetSize = 0;
+  for (size_t n = 0; n < numberOfSessions; ++n) {
+    runOnTheFlySession(n, ON_THE_FLY_SESSION_SIZE, &latencyMonitor);
+    if (n == 0) {
+      initialResidentSetSize = residentSetSize();
+    }
+  }
+
+  // sanitizers keep freed memory in quarantine
+  if (!SANITIZED) {
+    EXPECT_LE(residentSetSize(), initialResidentSetSize + maximalResidentSetSizeGrowth());
+  }
+  latencyMonitor.check(maximalLatency());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestStress, onTheFlyPathMatchingInstancesShareNoState)
+{
+  const size_t size = std::min<size_t>(iterations(), 4 * ON_THE_FLY_SESSION_SIZE);
+  const double expectedChecksum = runOnTheFlySession(7, size, nullptr);
+
+  std::vector<double> checksums(4);
+  std::vector<std::thread> threads;
+  for (size_t n = 0; n < checksums.size(); ++n) {
+    threads.emplace_back(
+      [&checksums, n, size]() {
+        checksums[n] = runOnTheFlySession(7, size, nullptr);
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  for (const double & checksum : checksums) {
+    EXPECT_DOUBLE_EQ(checksum, expectedChecksum);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestStress, pathMatchingWithReversalsAndConcurrentProjections)
+{
+  romea::core::PathMatching pathMatching(
+    std::string(TEST_DIR) + "/test_path_matching.cvs",
+    romea::core::makeGeodeticCoordinates(45.763066 / 180. * M_PI, 3.1093255 / 180. * M_PI, 457.3),
+    10.0, 3.0);
+
+  auto wayPoints = makeLemniscateWayPoints();
+  romea::core::Path2D path(wayPoints, 3.0);
+  pathMatching.setPath(romea::core::Path2D(wayPoints, 3.0));
+
+  // readers project point sets through the matcher between match calls, project is
+  // not safe while the path is matched or changed
+  std::mutex pathMatchingMutex;
+  std::atomic<bool> stop(false);
+  std::atomic<size_t> numberOfProjections(0);
+  std::vector<std::thread> readers;
+  for (unsigned int n = 0; n < 2; ++n) {
+    readers.emplace_back(
+      [&, n]() {
+        std::mt19937 generator(n);
+        std::uniform_real_distribution<double> uniform(-35., 35.);
+        std::vector<Eigen::Vector2d> points(2000);
+        romea::core::PathFrenetCoordinates2D coordinates;
+        while (!stop) {
+          for (auto & point : points) {
+            point = Eigen::Vector2d(uniform(generator), uniform(generator) / 3);
+          }
+          {
+            std::lock_guard<std::mutex> lock(pathMatchingMutex);
+            pathMatching.project(points, coordinates);
+          }
+          ++numberOfProjections;
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+      });
+  }
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  const auto & X = path.getSection(0).getX();
+  const auto & Y = path.getSection(0).getY();
+
+  // calls following a change of direction are monitored on their own
+  LatencyMonitor latencyMonitor;
+  LatencyMonitor manoeuvreLatencyMonitor;
+  size_t initialResidentSetSize = 0;
+  size_t numberOfMatches = 0;
+  size_t numberOfReversals = 0;
+  size_t lastReversal = 0;
+  double index = 0;
+  double direction = 1;
+  for (size_t n = 0; n < iterations(); ++n) {
+    if (uniform(generator) < 0.001) {
+      direction = -direction;
+      lastReversal = n;
+      ++numberOfReversals;
+    }
+    index = std::clamp(index + direction * 2 * uniform(generator), 0., X.size() - 2.);
+
+    size_t i = static_cast<size_t>(index);
+    romea::core::Pose2D pose;
+    pose.yaw = std::atan2(Y[i + 1] - Y[i], X[i + 1] - X[i]);
+    pose.position.x() = X[i] - std::sin(pose.yaw) * (uniform(generator) - 0.5);
+    pose.position.y() = Y[i] + std::cos(pose.yaw) * (uniform(generator) - 0.5);
+    romea::core::Twist2D twist;
+    twist.linearSpeeds.x() = direction;
+
+    bool manoeuvre = numberOfReversals != 0 && n < lastReversal + 10;
+    auto & monitor = manoeuvre ? manoeuvreLatencyMonitor : latencyMonitor;
+    std::unique_lock<std::mutex> lock(pathMatchingMutex);
+    auto matchedPoints = monitor.measure(
+      [&]() {
+        return pathMatching.match(romea::core::durationFromSecond(n * 0.1), pose, twist, 0.5);
+      });
+    numberOfMatches += !matchedPoints.empty();
+
+    // replanning replaces a part of the path by the same geometry
+    if (n % 50000 == 25000) {
+      std::vector<romea::core::PathWayPoint2D> splicedWayPoints(
+        wayPoints[0].begin() + 1000, wayPoints[0].begin() + 1100);
+      pathMatching.splicePath(0, 1000, 1100, splicedWayPoints);
+    }
+
+    if (n + 1 == LATENCY_WINDOW_SIZE) {
+      initialResidentSetSize = residentSetSize();
+    }
+  }
+
+  stop = true;
+  for (auto & reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_GT(numberOfProjections, 0u);
+  EXPECT_GT(numberOfMatches, iterations() * 9 / 10);
+  EXPECT_EQ(pathMatching.getNumberOfGlobalResearches(), 1u);
+  if (!SANITIZED && initialResidentSetSize != 0) {
+    EXPECT_LE(residentSetSize(), initialResidentSetSize + maximalResidentSetSizeGrowth());
+  }
+  latencyMonitor.check(maximalLatency());
+  if (numberOfReversals != 0) {
+    manoeuvreLatencyMonitor.check(maximalLatency());
+  }
+}
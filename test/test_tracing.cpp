@@ -0,0 +1,118 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+// romea
+#include "romea_core_path_matching/Tracing.hpp"
+
+namespace
+{
+
+nlohmann::json dumpTrace()
+{
+  std::stringstream stream;
+  romea::core::Tracer::writeChromeTrace(stream);
+  return nlohmann::json::parse(stream);
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+TEST(TestTracing, testChromeTraceHasEventsOfEveryThread)
+{
+  dumpTrace();
+
+  std::vector<std::thread> threads;
+  for (size_t n = 0; n < 3; ++n) {
+    threads.emplace_back(
+      []() {
+        for (size_t i = 0; i < 10; ++i) {
+          romea::core::TraceScope outer("outer");
+          romea::core::TraceScope inner("inner");
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  {
+    romea::core::TraceScope scope("main");
+  }
+
+  nlohmann::json trace = dumpTrace();
+  ASSERT_TRUE(trace.contains("traceEvents"));
+
+  std::map<std::string, size_t> counts;
+  std::set<size_t> threadIds;
+  for (const auto & event : trace["traceEvents"]) {
+    EXPECT_EQ(event["ph"].get<std::string>(), "X");
+    EXPECT_GE(event["dur"].get<double>(), 0.);
+    counts[event["name"].get<std::string>()]++;
+    threadIds.insert(event["tid"].get<size_t>());
+  }
+  EXPECT_EQ(counts["outer"], 30u);
+  EXPECT_EQ(counts["inner"], 30u);
+  EXPECT_EQ(counts["main"], 1u);
+  EXPECT_EQ(threadIds.size(), 4u);
+
+  // events are drained by the dump
+  EXPECT_TRUE(dumpTrace()["traceEvents"].empty());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTracing, testEventsAreDroppedWhenBufferIsFull)
+{
+  dumpTrace();
+  const size_t droppedEventsCount = romea::core::Tracer::getDroppedEventsCount();
+
+  const size_t capacity = romea::core::Tracer::THREAD_BUFFER_CAPACITY;
+  for (size_t n = 0; n < capacity + 10; ++n) {
+    romea::core::Tracer::record("event", 0, 1);
+  }
+
+  EXPECT_EQ(romea::core::Tracer::getDroppedEventsCount(), droppedEventsCount + 10);
+  EXPECT_EQ(dumpTrace()["traceEvents"].size(), capacity);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTracing, testBuffersOfFinishedThreadsAreRecycled)
+{
+  auto recordOnNewThread = []() {
+      std::thread thread([]() {romea::core::Tracer::record("event", 0, 1);});
+      thread.join();
+    };
+
+  recordOnNewThread();
+  dumpTrace();
+  const size_t numberOfThreadBuffers = romea::core::Tracer::getNumberOfThreadBuffers();
+
+  for (size_t n = 0; n < 10; ++n) {
+    recordOnNewThread();
+    EXPECT_EQ(dumpTrace()["traceEvents"].size(), 1u);
+  }
+  EXPECT_EQ(romea::core::Tracer::getNumberOfThreadBuffers(), numberOfThreadBuffers);
+}